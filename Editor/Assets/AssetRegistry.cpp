@@ -9,18 +9,17 @@ AssetRegistry   g_AssetRegistry{};
 
 Result::Code
 AssetRegistry::Load(const char* path) {
-    u8* blob{};
-    u64 length{};
+    MappedFile file{};
 
     Result::Code res{ Result::Ok };
-    res = ReadFile(path, blob, length);
+    res = file.Open(path, FileAccess::Sequential);
 
     if (Result::Fail(res)) {
         return res;
     }
 
     try {
-        json j{ json::parse(blob, blob + length) };
+        json j{ json::parse(file.Data(), file.Data() + file.Size()) };
         if (!j.contains("lastpacktime")) {
             LOG_ERROR("Invalid registry json!");
             return Result::EInvalidData;
@@ -43,8 +42,6 @@ AssetRegistry::Load(const char* path) {
         LOG_ERROR("Json missing key: %s", e.what());
     }
 
-    MemFree(blob);
-
     return Result::Ok;
 }
 }
@@ -1,4 +1,5 @@
 #include <Iron.AssetCompiler/Src/Shaders.h>
+#include <Iron.FileSystem/FileSystem.h>
 
 namespace Iron::AssetCompiler {
 std::wstring
@@ -12,19 +13,10 @@ CShader::SaveToFile(const char* filePath) {
         return Result::ENullptr;
     }
 
-    const u64 total_size{ sizeof(u32) + m_Size };
+    FS::ShaderAsset asset{};
+    asset.Bytecode = { m_Blob, m_Size };
 
-    u8* buffer{ (u8*)MemAlloc(total_size) };
-    if (!buffer) {
-        return Result::ENomemory;
-    }
-
-    *(u32*)buffer = AssetType::Shader;
-    MemCopy(buffer + sizeof(u32), m_Blob, m_Size);
-
-    Result::Code res{ WriteFile(filePath, buffer, total_size) };
-
-    return res;
+    return SaveSerialized(filePath, asset, FileWriteFlags::CreateDirectories);
 }
 
 CShaderCompilerD3D::CShaderCompilerD3D(
@@ -15,12 +15,12 @@ class CShader : public IShader {
 public:
     CShader(u8* blob, u64 size)
         : m_Blob(nullptr), m_Size(size) {
-        m_Blob = (u8*)MemAlloc(m_Size);
+        m_Blob = (u8*)MemAlloc(m_Size, MemTag::Assets);
         MemCopy(m_Blob, blob, m_Size);
     }
 
     void Release() override {
-        MemFree(m_Blob);
+        MemFree(m_Blob, MemTag::Assets);
         m_Blob = nullptr;
         m_Size = 0;
     }
@@ -0,0 +1,76 @@
+#pragma once
+#include <Iron.Core/Core.h>
+
+#include <chrono>
+#include <stdio.h>
+
+// Stress tests and benchmarks for Iron.Core. A case returns false when one of its checks
+// fails and prints its timings with Report(). Cases register themselves at static init:
+//
+//   IRON_BENCH(SpscRingOrder) {
+//       ...
+//       BENCH_CHECK(Popped == Pushed);
+//       return true;
+//   }
+namespace Iron::Bench {
+typedef bool(*CaseFunc)();
+
+struct Case {
+    const char*     Name;
+    CaseFunc        Func;
+    Case*           Next;
+};
+
+/// Links C at the end of the case list, cases run in registration order
+void RegisterCase(Case& C);
+
+struct Registrar {
+    Registrar(Case& C) { RegisterCase(C); }
+};
+
+#define IRON_BENCH(Name)                                                        \
+    bool Name();                                                                \
+    ::Iron::Bench::Case g_Case##Name{ #Name, &Name, nullptr };                  \
+    ::Iron::Bench::Registrar g_Register##Name{ g_Case##Name };                  \
+    bool Name()
+
+#define BENCH_CHECK(x)                                                          \
+    do {                                                                        \
+        if (!(x)) {                                                             \
+            printf("  %s(%d): check failed: %s\n", __FILE__, __LINE__, #x);     \
+            return false;                                                       \
+        }                                                                       \
+    } while (0)
+
+class Timer {
+public:
+    Timer() : m_Start(std::chrono::steady_clock::now()) {}
+
+    double Ms() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_Start).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point m_Start;
+};
+
+/// Hardware threads, at least 1
+u32 GetMaxThreads();
+
+/// Thread counts to measure scaling with, 1, 2, 4 ... up to and including Max
+template<typename F>
+void
+ForEachThreadCount(u32 Max, F&& Func) {
+    for (u32 Threads{ 1 }; Threads < Max; Threads <<= 1) {
+        Func(Threads);
+    }
+    Func(Max);
+}
+
+/// One line per measurement, Ops is the number of operations timed
+inline void
+Report(const char* What, u32 Threads, double Ms, u64 Ops) {
+    printf("  %-32s threads %3u %10.2f ms %10.2f Mops/s\n",
+        What, Threads, Ms, Ms > 0.0 ? (double)Ops / Ms / 1000.0 : 0.0);
+}
+}
@@ -0,0 +1,57 @@
+#include <Iron.Bench/Src/Bench.h>
+#include <Iron.Core/CVar.h>
+
+#include <stdio.h>
+#include <string.h>
+
+// Settings saved on shutdown, the way EngineContext does it: CVars changed while running are
+// written back, edits made to the file meanwhile are kept
+namespace Iron::Bench {
+namespace {
+constexpr const char* SettingsPath{ "Iron.Bench.settings.ini" };
+
+CVar<s32> g_ChangedValue{ "bench", "changed", 1, "Set while running" };
+CVar<s32> g_UntouchedValue{ "bench", "untouched", 1, "Edited in the file while running" };
+
+bool
+WriteSettings(const char* Text) {
+    FILE* F{ nullptr };
+    fopen_s(&F, SettingsPath, "w");
+    if (!F) {
+        return false;
+    }
+
+    fputs(Text, F);
+    fclose(F);
+    return true;
+}
+} // anonymous namespace
+
+IRON_BENCH(ConfigSaveKeepsCVarChanges) {
+    BENCH_CHECK(WriteSettings("[bench]\nchanged=1\nuntouched=1\nnote=before\n"));
+
+    ConfigFile Settings{};
+    ConfigFile AsRead{};
+    BENCH_CHECK(Result::Success(Settings.Load(SettingsPath)));
+    AsRead.Merge(Settings);
+    BindCVarConfig(&Settings);
+
+    BENCH_CHECK(Result::Success(SetCVar("bench.changed", "7")));
+    BENCH_CHECK(WriteSettings("[bench]\nchanged=1\nuntouched=5\nnote=after\n"));
+
+    // Shutdown
+    SaveCVars(Settings);
+    const Result::Code Res{ Settings.SaveChanges(SettingsPath, AsRead) };
+    BindCVarConfig(nullptr);
+    BENCH_CHECK(Result::Success(Res));
+
+    ConfigFile Saved{};
+    BENCH_CHECK(Result::Success(Saved.Load(SettingsPath)));
+    BENCH_CHECK(Saved.GetInt("bench", "changed") == 7);
+    BENCH_CHECK(Saved.GetInt("bench", "untouched") == 5);
+    BENCH_CHECK(!strcmp(Saved.Get("bench", "note", ""), "after"));
+
+    remove(SettingsPath);
+    return true;
+}
+}
@@ -0,0 +1,193 @@
+#include <Iron.Bench/Src/Bench.h>
+
+#include <functional>
+#include <unordered_map>
+
+// HashMap against std::unordered_map on the lookups it replaced in the renderer: pipeline
+// hashes in CRHIDevice_DX12::m_PsoMap, and the per compile view caches of the frame graphs
+namespace Iron::Bench {
+namespace {
+constexpr u32 PipelineCount{ 4096 };
+constexpr u32 PipelineLookups{ 20'000'000 };
+constexpr u32 ViewFrames{ 20'000 };
+constexpr u32 ViewsPerFrame{ 512 };
+constexpr u32 DistinctViews{ 192 };
+
+struct Rng {
+    u64 State;
+
+    u64 Next() {
+        State ^= State << 13;
+        State ^= State >> 7;
+        State ^= State << 17;
+        return State;
+    }
+};
+
+// Same layout and hash as ViewCacheEntry and ViewCacheHasher in Iron.RHI
+struct ViewKey {
+    u32     Resource;
+    u32     Format;
+    u32     BaseMip;
+    u32     MipCount;
+    u32     BaseLayer;
+    u32     LayerCount;
+    u32     Plane;
+
+    bool operator==(const ViewKey& Other) const {
+        return Resource == Other.Resource && Format == Other.Format && BaseMip == Other.BaseMip
+            && MipCount == Other.MipCount && BaseLayer == Other.BaseLayer
+            && LayerCount == Other.LayerCount && Plane == Other.Plane;
+    }
+};
+
+struct ViewKeyHasher {
+    size_t operator()(const ViewKey& Key) const noexcept {
+        size_t Hash{ 0 };
+        const u32 Fields[]{ Key.Resource, Key.Format, Key.BaseMip, Key.MipCount,
+            Key.BaseLayer, Key.LayerCount, Key.Plane };
+        for (u32 Field : Fields) {
+            Hash ^= std::hash<u32>{}(Field) + 0x9e3779b97f4a7c15ull + (Hash << 6) + (Hash >> 2);
+        }
+        return Hash;
+    }
+};
+
+// A frame graph reads the same few resources through many passes
+ViewKey
+MakeViewKey(Rng& R) {
+    const u32 Id{ (u32)(R.Next() % DistinctViews) };
+    return ViewKey{ Id, 28 + (Id & 3), Id & 7, 1, 0, 1, 0 };
+}
+
+void
+MakePipelineHashes(Vector<u64>& Hashes) {
+    Rng R{ 0x9e3779b97f4a7c15ull };
+    Hashes.Resize(PipelineCount);
+    for (u32 I{ 0 }; I < PipelineCount; ++I) {
+        Hashes[I] = R.Next();
+    }
+}
+
+// 1 in 8 lookups misses, like a pipeline created for the first time
+void
+MakeLookups(const Vector<u64>& Hashes, Vector<u64>& Lookups) {
+    Rng R{ 12345 };
+    Lookups.Resize(PipelineLookups);
+    for (u32 I{ 0 }; I < PipelineLookups; ++I) {
+        const u64 Pick{ R.Next() };
+        Lookups[I] = (Pick & 7) ? Hashes[(u32)(Pick >> 32) % PipelineCount] : Pick;
+    }
+}
+} // anonymous namespace
+
+IRON_BENCH(HashMapAgainstReference) {
+    HashMap<u64, u64> Map{};
+    std::unordered_map<u64, u64> Reference{};
+    Rng R{ 7 };
+
+    // Small key range so inserts, overwrites and erases hit the same keys over and over
+    for (u32 I{ 0 }; I < 2'000'000; ++I) {
+        const u64 Key{ R.Next() % 20'000 };
+        const u64 Op{ R.Next() % 4 };
+        if (Op == 0) {
+            BENCH_CHECK(Map.Erase(Key) == (Reference.erase(Key) != 0));
+        }
+        else {
+            Map.Emplace(Key, I);
+            Reference[Key] = I;
+        }
+    }
+
+    BENCH_CHECK(Map.Size() == (u32)Reference.size());
+    for (const auto& [Key, Value] : Reference) {
+        const u64* Found{ Map.Find(Key) };
+        BENCH_CHECK(Found && *Found == Value);
+    }
+
+    u32 Visited{ 0 };
+    for (const auto& P : Map) {
+        const auto It{ Reference.find(P.Key) };
+        BENCH_CHECK(It != Reference.end() && It->second == P.Value);
+        ++Visited;
+    }
+    BENCH_CHECK(Visited == Map.Size());
+    return true;
+}
+
+IRON_BENCH(HashMapPipelineLookups) {
+    Vector<u64> Hashes{};
+    Vector<u64> Lookups{};
+    MakePipelineHashes(Hashes);
+    MakeLookups(Hashes, Lookups);
+
+    HashMap<u64, u32> Map{};
+    std::unordered_map<u64, u32> Reference{};
+    for (u32 I{ 0 }; I < PipelineCount; ++I) {
+        Map.Emplace(Hashes[I], I);
+        Reference.emplace(Hashes[I], I);
+    }
+
+    u64 MapSum{ 0 };
+    {
+        const Timer Time{};
+        for (u32 I{ 0 }; I < PipelineLookups; ++I) {
+            const u32* Found{ Map.Find(Lookups[I]) };
+            MapSum += Found ? *Found + 1 : 0;
+        }
+        Report("HashMap pipeline lookups", 1, Time.Ms(), PipelineLookups);
+    }
+
+    u64 ReferenceSum{ 0 };
+    {
+        const Timer Time{};
+        for (u32 I{ 0 }; I < PipelineLookups; ++I) {
+            const auto It{ Reference.find(Lookups[I]) };
+            ReferenceSum += It != Reference.end() ? It->second + 1 : 0;
+        }
+        Report("unordered_map pipeline lookups", 1, Time.Ms(), PipelineLookups);
+    }
+
+    BENCH_CHECK(MapSum == ReferenceSum);
+    return true;
+}
+
+IRON_BENCH(HashMapViewCache) {
+    // Each frame graph compile builds its cache from scratch, find or insert per view
+    Vector<ViewKey> Views{};
+    Rng R{ 99 };
+    Views.Resize(ViewsPerFrame);
+    for (u32 I{ 0 }; I < ViewsPerFrame; ++I) {
+        Views[I] = MakeViewKey(R);
+    }
+
+    u64 MapSum{ 0 };
+    {
+        const Timer Time{};
+        for (u32 Frame{ 0 }; Frame < ViewFrames; ++Frame) {
+            HashMap<ViewKey, u32, ViewKeyHasher> Cache{};
+            for (u32 I{ 0 }; I < ViewsPerFrame; ++I) {
+                const u32* Found{ Cache.Find(Views[I]) };
+                MapSum += Found ? *Found : *Cache.Emplace(Views[I], I);
+            }
+        }
+        Report("HashMap view cache", 1, Time.Ms(), (u64)ViewFrames * ViewsPerFrame);
+    }
+
+    u64 ReferenceSum{ 0 };
+    {
+        const Timer Time{};
+        for (u32 Frame{ 0 }; Frame < ViewFrames; ++Frame) {
+            std::unordered_map<ViewKey, u32, ViewKeyHasher> Cache{};
+            for (u32 I{ 0 }; I < ViewsPerFrame; ++I) {
+                const auto It{ Cache.find(Views[I]) };
+                ReferenceSum += It != Cache.end() ? It->second : Cache.emplace(Views[I], I).first->second;
+            }
+        }
+        Report("unordered_map view cache", 1, Time.Ms(), (u64)ViewFrames * ViewsPerFrame);
+    }
+
+    BENCH_CHECK(MapSum == ReferenceSum);
+    return true;
+}
+}
@@ -0,0 +1,64 @@
+#include <Iron.Bench/Src/Bench.h>
+
+#include <string.h>
+#include <thread>
+
+#pragma comment(lib, "iron.core.lib")
+
+using namespace Iron;
+
+namespace Iron::Bench {
+namespace {
+Case* g_Head{};
+Case* g_Tail{};
+} // anonymous namespace
+
+void
+RegisterCase(Case& C) {
+    C.Next = nullptr;
+    if (g_Tail) {
+        g_Tail->Next = &C;
+    }
+    else {
+        g_Head = &C;
+    }
+    g_Tail = &C;
+}
+
+u32
+GetMaxThreads() {
+    return Math::Max(std::thread::hardware_concurrency(), 1u);
+}
+}
+
+int
+main(int ArgC, char** ArgV) {
+    if (ArgC > 1 && (!strcmp(ArgV[1], "-h") || !strcmp(ArgV[1], "--help"))) {
+        printf("Usage: Iron.Bench [filter]\nRuns every case whose name contains filter\n");
+        return 0;
+    }
+
+    const char* Filter{ ArgC > 1 ? ArgV[1] : nullptr };
+    u32 Run{ 0 };
+    u32 Failed{ 0 };
+
+    for (Bench::Case* C{ Bench::g_Head }; C; C = C->Next) {
+        if (Filter && !strstr(C->Name, Filter)) {
+            continue;
+        }
+
+        printf("%s\n", C->Name);
+        ++Run;
+
+        const Bench::Timer Time{};
+        const bool Passed{ C->Func() };
+        printf("%s %s (%.0f ms)\n", Passed ? "[PASS]" : "[FAIL]", C->Name, Time.Ms());
+
+        if (!Passed) {
+            ++Failed;
+        }
+    }
+
+    printf("%u of %u cases passed\n", Run - Failed, Run);
+    return Failed ? 1 : 0;
+}
@@ -0,0 +1,161 @@
+#include <Iron.Bench/Src/Bench.h>
+#include <Iron.Core/Concurrent.h>
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+// Scaling of the parallel algorithms from 1 to N job threads. Every run is checked against
+// a serial result computed up front.
+namespace Iron::Bench {
+namespace {
+constexpr u32 ForCount{ 16 * 1024 * 1024 };
+constexpr u32 ReduceCount{ 64 * 1024 * 1024 };
+constexpr u32 ScanCount{ 32 * 1024 * 1024 };
+constexpr u32 SortCount{ 8 * 1024 * 1024 };
+
+u64
+NextRandom(u64& State) {
+    State ^= State << 13;
+    State ^= State >> 7;
+    State ^= State << 17;
+    return State;
+}
+
+// One thread runs without the job system, the algorithms then run inline
+bool
+StartJobThreads(u32 Threads) {
+    return Threads == 1 || Result::Success(InitializeJobSystem(Threads - 1));
+}
+
+void
+StopJobThreads(u32 Threads) {
+    if (Threads > 1) {
+        ShutdownJobSystem();
+    }
+}
+
+// Runs Func(Threads) for every thread count, false if any run failed
+template<typename F>
+bool
+MeasureScaling(F&& Func) {
+    bool Passed{ true };
+    ForEachThreadCount(GetMaxThreads(), [&](u32 Threads) {
+        if (!StartJobThreads(Threads)) {
+            printf("  Failed to start %u job threads\n", Threads);
+            Passed = false;
+            return;
+        }
+
+        Passed &= Func(Threads);
+        StopJobThreads(Threads);
+    });
+    return Passed;
+}
+
+// Enough math per element that the loop is not purely memory bound, like a transform update
+inline f32
+Transform(f32 Value) {
+    return sqrtf(Value * 1.5f + 2.f) * 0.75f;
+}
+} // anonymous namespace
+
+IRON_BENCH(ParallelForScaling) {
+    Vector<f32> Values{};
+    Values.Resize(ForCount);
+
+    return MeasureScaling([&](u32 Threads) {
+        for (u32 I{ 0 }; I < ForCount; ++I) {
+            Values[I] = (f32)(I & 1023);
+        }
+
+        const Timer Time{};
+        ParallelFor(Values, [](f32& Value) { Value = Transform(Value); });
+        Report("ParallelFor transform", Threads, Time.Ms(), ForCount);
+
+        for (u32 I{ 0 }; I < ForCount; ++I) {
+            BENCH_CHECK(Values[I] == Transform((f32)(I & 1023)));
+        }
+        return true;
+    });
+}
+
+IRON_BENCH(ParallelReduceScaling) {
+    Vector<u32> Values{};
+    Values.Resize(ReduceCount);
+
+    u64 Expected{ 0 };
+    u64 Seed{ 1 };
+    for (u32 I{ 0 }; I < ReduceCount; ++I) {
+        Values[I] = (u32)NextRandom(Seed);
+        Expected += Values[I];
+    }
+
+    return MeasureScaling([&](u32 Threads) {
+        const u32* Data{ Values.Data() };
+
+        const Timer Time{};
+        const u64 Sum{ ParallelReduce(ReduceCount, (u64)0,
+            [Data](u32 I) { return (u64)Data[I]; },
+            [](u64 A, u64 B) { return A + B; }) };
+        Report("ParallelReduce sum", Threads, Time.Ms(), ReduceCount);
+
+        BENCH_CHECK(Sum == Expected);
+        return true;
+    });
+}
+
+IRON_BENCH(ParallelScanScaling) {
+    Vector<u32> In{};
+    Vector<u32> Out{};
+    Vector<u32> Expected{};
+    In.Resize(ScanCount);
+    Out.Resize(ScanCount);
+    Expected.Resize(ScanCount);
+
+    // Exclusive prefix sum, wrapping like the u32 math of the scan itself
+    u64 Seed{ 2 };
+    u32 Running{ 0 };
+    for (u32 I{ 0 }; I < ScanCount; ++I) {
+        In[I] = (u32)NextRandom(Seed) & 0xffff;
+        Expected[I] = Running;
+        Running += In[I];
+    }
+
+    return MeasureScaling([&](u32 Threads) {
+        const Timer Time{};
+        ParallelScan(In.Data(), Out.Data(), ScanCount, 0u, [](u32 A, u32 B) { return A + B; });
+        Report("ParallelScan exclusive sum", Threads, Time.Ms(), ScanCount);
+
+        BENCH_CHECK(!memcmp(Out.Data(), Expected.Data(), sizeof(u32) * ScanCount));
+        return true;
+    });
+}
+
+IRON_BENCH(ParallelSortScaling) {
+    // Draw keys, random 64 bit values
+    Vector<u64> Keys{};
+    Vector<u64> Expected{};
+    Keys.Resize(SortCount);
+    Expected.Resize(SortCount);
+
+    u64 Seed{ 3 };
+    for (u32 I{ 0 }; I < SortCount; ++I) {
+        Expected[I] = NextRandom(Seed);
+    }
+
+    Vector<u64> Original{ Expected };
+    std::sort(Expected.begin(), Expected.end());
+
+    return MeasureScaling([&](u32 Threads) {
+        MemCopy(Keys.Data(), Original.Data(), sizeof(u64) * SortCount);
+
+        const Timer Time{};
+        ParallelSort(Keys);
+        Report("ParallelSort u64 keys", Threads, Time.Ms(), SortCount);
+
+        BENCH_CHECK(!memcmp(Keys.Data(), Expected.Data(), sizeof(u64) * SortCount));
+        return true;
+    });
+}
+}
@@ -0,0 +1,199 @@
+#include <Iron.Bench/Src/Bench.h>
+#include <Iron.Core/Concurrent.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace Iron::Bench {
+namespace {
+constexpr u32 SpscItems{ 20'000'000 };
+constexpr u32 ItemsPerProducer{ 2'000'000 };
+constexpr u32 QueueCapacity{ 1024 };
+
+// Producer index in the high half, sequence number in the low half
+constexpr u64
+MakeItem(u32 Producer, u32 Sequence) {
+    return ((u64)Producer << 32) | Sequence;
+}
+
+// Releases all threads at once so they start contending together
+struct StartGate {
+    std::atomic<u32>    Ready{};
+    std::atomic<bool>   Go{};
+
+    void Wait() {
+        Ready.fetch_add(1);
+        while (!Go.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+
+    void Open(u32 Threads) {
+        while (Ready.load() != Threads) {
+            std::this_thread::yield();
+        }
+        Go.store(true, std::memory_order_release);
+    }
+};
+
+// Per producer, every consumer must see increasing sequence numbers, and every item must
+// arrive exactly once
+struct ConsumerState {
+    std::vector<u32>    NextExpected;
+    u64                 Popped{};
+    bool                Ordered{ true };
+
+    explicit ConsumerState(u32 Producers) : NextExpected(Producers, 0) {}
+
+    void Check(u64 Item) {
+        const u32 Producer{ (u32)(Item >> 32) };
+        const u32 Sequence{ (u32)Item };
+        if (Producer >= NextExpected.size() || Sequence < NextExpected[Producer]) {
+            Ordered = false;
+            return;
+        }
+
+        NextExpected[Producer] = Sequence + 1;
+        ++Popped;
+    }
+};
+
+template<typename Queue, typename PushF, typename PopF>
+bool
+RunContention(const char* What, u32 Producers, u32 Consumers, Queue& Q, PushF Push, PopF Pop) {
+    const u64 Total{ (u64)Producers * ItemsPerProducer };
+    std::atomic<u64> Consumed{};
+    std::vector<ConsumerState> States(Consumers, ConsumerState{ Producers });
+    std::vector<u64> Sums(Consumers, 0);
+    StartGate Gate{};
+    std::vector<std::thread> Threads{};
+
+    for (u32 P{ 0 }; P < Producers; ++P) {
+        Threads.emplace_back([&, P] {
+            Gate.Wait();
+            for (u32 I{ 0 }; I < ItemsPerProducer; ++I) {
+                while (!Push(Q, MakeItem(P, I))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (u32 C{ 0 }; C < Consumers; ++C) {
+        Threads.emplace_back([&, C] {
+            Gate.Wait();
+            u64 Item{};
+            while (Consumed.load(std::memory_order_relaxed) < Total) {
+                if (!Pop(Q, Item)) {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                States[C].Check(Item);
+                Sums[C] += (u32)Item;
+                Consumed.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    Gate.Open(Producers + Consumers);
+    const Timer Time{};
+    for (std::thread& T : Threads) {
+        T.join();
+    }
+    const double Ms{ Time.Ms() };
+
+    u64 Popped{ 0 };
+    u64 Sum{ 0 };
+    for (u32 C{ 0 }; C < Consumers; ++C) {
+        BENCH_CHECK(States[C].Ordered);
+        Popped += States[C].Popped;
+        Sum += Sums[C];
+    }
+
+    BENCH_CHECK(Popped == Total);
+    BENCH_CHECK(Sum == (u64)Producers * ((u64)ItemsPerProducer * (ItemsPerProducer - 1) / 2));
+
+    Report(What, Producers + Consumers, Ms, Total);
+    return true;
+}
+} // anonymous namespace
+
+IRON_BENCH(SpscRingStress) {
+    SpscRing<u64> Ring{};
+    BENCH_CHECK(Result::Success(Ring.Initialize(QueueCapacity)));
+    BENCH_CHECK(Ring.Capacity() == QueueCapacity);
+
+    std::thread Producer{ [&Ring] {
+        for (u32 I{ 0 }; I < SpscItems; ++I) {
+            while (!Ring.TryPush(I)) {
+                std::this_thread::yield();
+            }
+        }
+    } };
+
+    const Timer Time{};
+    bool Ordered{ true };
+    u64 Item{};
+    for (u32 Expected{ 0 }; Expected < SpscItems;) {
+        if (!Ring.TryPop(Item)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        Ordered &= Item == Expected;
+        ++Expected;
+    }
+    const double Ms{ Time.Ms() };
+    Producer.join();
+
+    BENCH_CHECK(Ordered);
+    BENCH_CHECK(!Ring.Peek());
+    Report("SpscRing push/pop", 2, Ms, SpscItems);
+    return true;
+}
+
+IRON_BENCH(MpmcQueueContention) {
+    const u32 Max{ Math::Max(GetMaxThreads() / 2, 1u) };
+    bool Passed{ true };
+
+    ForEachThreadCount(Max, [&](u32 Threads) {
+        MpmcQueue<u64> Queue{};
+        if (Result::Fail(Queue.Initialize(QueueCapacity))) {
+            Passed = false;
+            return;
+        }
+
+        Passed &= RunContention("MpmcQueue producers = consumers", Threads, Threads, Queue,
+            [](MpmcQueue<u64>& Q, u64 Item) { return Q.TryPush(Item); },
+            [](MpmcQueue<u64>& Q, u64& Item) { return Q.TryPop(Item); });
+    });
+
+    return Passed;
+}
+
+IRON_BENCH(MpmcQueueFull) {
+    // A tiny queue keeps producers and consumers on the full and empty edges all the time
+    MpmcQueue<u64> Queue{};
+    BENCH_CHECK(Result::Success(Queue.Initialize(2)));
+
+    return RunContention("MpmcQueue capacity 2", 4, 4, Queue,
+        [](MpmcQueue<u64>& Q, u64 Item) { return Q.TryPush(Item); },
+        [](MpmcQueue<u64>& Q, u64& Item) { return Q.TryPop(Item); });
+}
+
+IRON_BENCH(MpscQueueContention) {
+    const u32 Max{ Math::Max(GetMaxThreads() - 1, 1u) };
+    bool Passed{ true };
+
+    ForEachThreadCount(Max, [&](u32 Threads) {
+        MpscQueue<u64> Queue{};
+        Passed &= RunContention("MpscQueue producers, 1 consumer", Threads, 1, Queue,
+            [](MpscQueue<u64>& Q, u64 Item) { return Q.Push(Item); },
+            [](MpscQueue<u64>& Q, u64& Item) { return Q.TryPop(Item); });
+    });
+
+    return Passed;
+}
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include <Iron.Core/Core.h>
+
+#include <atomic>
+#include <bit>
+#include <type_traits>
+
+// Console variables, declared at namespace scope next to the code that reads them:
+//
+//   CVar<bool> g_AllowTearing{ "renderer", "allow_tearing", false, "Present without waiting for vblank" };
+//
+// Get() is a relaxed atomic load with no lookup. Set() runs the change callbacks on the
+// calling thread when the value actually changed. Variables are persisted as Name=Value
+// under [Section] of the ConfigFile bound with BindCVarConfig.
+namespace Iron {
+struct CVarType {
+    enum Type : u32 {
+        Bool = 0,
+        Int,
+        Float,
+
+        Count,
+    };
+};
+
+struct CVarFlags {
+    enum Flags : u32 {
+        None = 0,
+        ReadOnly = 1 << 0,      // Read once at startup, only config files can change it
+        NoSave = 1 << 1,        // Never written back by SaveCVars
+    };
+};
+
+class CVarBase;
+
+using CVarCallback = void(*)(CVarBase& Var, void* UserData);
+
+constexpr u32 MaxCVarCallbacks{ 4 };
+
+class CVarBase {
+public:
+    CVarBase(const CVarBase&) = delete;
+    CVarBase& operator=(const CVarBase&) = delete;
+
+    constexpr const char* GetSection() const { return m_Section; }
+    constexpr const char* GetName() const { return m_Name; }
+    constexpr const char* GetDescription() const { return m_Description; }
+    constexpr CVarType::Type GetType() const { return m_Type; }
+    constexpr u32 GetFlags() const { return m_Flags; }
+
+    /// Parses Value for the variable type and sets it, false if it doesn't parse
+    CORE_API bool SetFromString(const char* Value);
+    /// Null terminated, returns the length written
+    CORE_API u32 ToString(char* Buffer, u32 Size) const;
+    CORE_API void Reset();
+
+    CORE_API bool AddCallback(CVarCallback Callback, void* UserData = nullptr);
+    CORE_API void RemoveCallback(CVarCallback Callback, void* UserData = nullptr);
+
+protected:
+    CORE_API CVarBase(const char* Section, const char* Name, const char* Description,
+        CVarType::Type Type, u32 DefaultBits, u32 Flags);
+    CORE_API ~CVarBase();
+
+    /// Stores the value and runs the callbacks if it changed
+    CORE_API void SetBits(u32 Bits);
+
+    // Every type fits in 32 bits, so all variables share one untyped atomic
+    std::atomic<u32>    m_Bits;
+
+private:
+    struct Callback {
+        CVarCallback    Func;
+        void*           UserData;
+    };
+
+    friend struct CVarRegistry;
+
+    const char*         m_Section;
+    const char*         m_Name;
+    const char*         m_Description;
+    CVarType::Type      m_Type;
+    u32                 m_Flags;
+    u32                 m_DefaultBits;
+    u64                 m_Hash;
+    CVarBase*           m_Next{};
+    Callback            m_Callbacks[MaxCVarCallbacks]{};
+    u32                 m_CallbackCount{ 0 };
+};
+
+template<typename T>
+class CVar : public CVarBase {
+    static_assert(std::is_same_v<T, bool> || std::is_same_v<T, s32> || std::is_same_v<T, f32>,
+        "CVars hold bool, s32 or f32");
+
+public:
+    constexpr static CVarType::Type Type{ std::is_same_v<T, bool> ? CVarType::Bool
+        : std::is_same_v<T, s32> ? CVarType::Int : CVarType::Float };
+
+    CVar(const char* Section, const char* Name, T Default, const char* Description,
+        u32 Flags = CVarFlags::None)
+        : CVarBase(Section, Name, Description, Type, ToBits(Default), Flags) {
+    }
+
+    T Get() const {
+        return FromBits(m_Bits.load(std::memory_order_relaxed));
+    }
+
+    void Set(T Value) {
+        SetBits(ToBits(Value));
+    }
+
+    operator T() const {
+        return Get();
+    }
+
+private:
+    constexpr static u32 ToBits(T Value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            return Value ? 1u : 0u;
+        }
+        else {
+            return std::bit_cast<u32>(Value);
+        }
+    }
+
+    constexpr static T FromBits(u32 Bits) {
+        if constexpr (std::is_same_v<T, bool>) {
+            return Bits != 0;
+        }
+        else {
+            return std::bit_cast<T>(Bits);
+        }
+    }
+};
+
+/// Full name is "Section.Name"
+CORE_API CVarBase* FindCVar(const char* FullName);
+/// For consoles and tools, refuses ReadOnly variables
+CORE_API Result::Code SetCVar(const char* FullName, const char* Value);
+/// Calls Func for every registered variable, registration is blocked meanwhile
+CORE_API void ForEachCVar(void(*Func)(CVarBase& Var, void* UserData), void* UserData);
+
+/// Sets every registered variable found in Config, also ReadOnly ones
+CORE_API void LoadCVars(const ConfigFile& Config);
+/// Writes every variable without the NoSave flag into Config. ReadOnly variables are only
+/// added when missing, so an edit waiting for a restart is not overwritten.
+CORE_API void SaveCVars(ConfigFile& Config);
+/// Loads Config like LoadCVars, variables registered later, e.g. by modules loaded afterwards,
+/// take their value from it too. Config must outlive the binding, pass nullptr to unbind.
+CORE_API void BindCVarConfig(const ConfigFile* Config);
+}
@@ -0,0 +1,702 @@
+#pragma once
+#include <Iron.Core/Core.h>
+
+#include <atomic>
+#include <type_traits>
+
+// Lock-free queues, the job system and the parallel algorithms built on it.
+// Kept out of Core.h so only modules that need <atomic> pay for it.
+namespace Iron {
+//Bounded single producer, single consumer ring.
+//Each side caches the other side's index and only reloads it when the ring looks full/empty.
+template<typename T>
+class SpscRing {
+public:
+    SpscRing() = default;
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    ~SpscRing() {
+        Release();
+    }
+
+    //Capacity is rounded up to a power of two
+    Result::Code Initialize(u32 Capacity) {
+        if (!Capacity || Capacity > (1u << 31)) {
+            return Result::EInvalidarg;
+        }
+
+        Release();
+
+        u32 Size{ 1 };
+        while (Size < Capacity) {
+            Size <<= 1;
+        }
+
+        m_Data = (T*)HeapAllocator::Allocate<alignof(T)>(sizeof(T) * Size);
+        if (!m_Data) {
+            return Result::ENomemory;
+        }
+
+        m_Mask = Size - 1;
+        m_Head.store(0, std::memory_order_relaxed);
+        m_Tail.store(0, std::memory_order_relaxed);
+        m_CachedHead = 0;
+        m_CachedTail = 0;
+
+        return Result::Ok;
+    }
+
+    //Not thread safe, both sides must be idle
+    void Release() {
+        if (!m_Data) {
+            return;
+        }
+
+        const u32 Tail{ m_Tail.load(std::memory_order_relaxed) };
+        for (u32 I{ m_Head.load(std::memory_order_relaxed) }; I != Tail; ++I) {
+            m_Data[I & m_Mask].~T();
+        }
+
+        HeapAllocator::Free<alignof(T)>(m_Data);
+        m_Data = nullptr;
+        m_Mask = 0;
+    }
+
+    //Producer only. Returns false if the ring is full
+    template<typename... Args>
+    bool TryEmplace(Args&&... args) {
+        const u32 Tail{ m_Tail.load(std::memory_order_relaxed) };
+        if (Tail - m_CachedHead > m_Mask) {
+            m_CachedHead = m_Head.load(std::memory_order_acquire);
+            if (Tail - m_CachedHead > m_Mask) {
+                return false;
+            }
+        }
+
+        new (&m_Data[Tail & m_Mask]) T(static_cast<Args&&>(args)...);
+        m_Tail.store(Tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPush(const T& Value) { return TryEmplace(Value); }
+    bool TryPush(T&& Value) { return TryEmplace(static_cast<T&&>(Value)); }
+
+    //Consumer only. Returns false if the ring is empty
+    bool TryPop(T& Out) {
+        T* Front{ Peek() };
+        if (!Front) {
+            return false;
+        }
+
+        Out = Move(*Front);
+        Front->~T();
+        m_Head.store(m_Head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        return true;
+    }
+
+    //Consumer only. The element stays valid until it is popped
+    T* Peek() {
+        const u32 Head{ m_Head.load(std::memory_order_relaxed) };
+        if (Head == m_CachedTail) {
+            m_CachedTail = m_Tail.load(std::memory_order_acquire);
+            if (Head == m_CachedTail) {
+                return nullptr;
+            }
+        }
+
+        return &m_Data[Head & m_Mask];
+    }
+
+    //Only exact when called from one of the two sides while the other is idle
+    u32 SizeApprox() const {
+        return m_Tail.load(std::memory_order_acquire) - m_Head.load(std::memory_order_acquire);
+    }
+
+    constexpr u32 Capacity() const { return m_Data ? m_Mask + 1 : 0; }
+
+private:
+    alignas(CacheLineSize) std::atomic<u32> m_Head{};      //Written by the consumer
+    u32                                     m_CachedTail{};
+    alignas(CacheLineSize) std::atomic<u32> m_Tail{};      //Written by the producer
+    u32                                     m_CachedHead{};
+    alignas(CacheLineSize) T*               m_Data{};
+    u32                                     m_Mask{};
+};
+
+//Bounded multi producer, multi consumer queue (Vyukov). Every cell carries a sequence
+//number, so producers and consumers only contend on their own index.
+template<typename T, typename Allocator = HeapAllocator>
+class MpmcQueue {
+public:
+    MpmcQueue() = default;
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    ~MpmcQueue() {
+        Release();
+    }
+
+    //Capacity is rounded up to a power of two, minimum 2
+    Result::Code Initialize(u32 Capacity) {
+        if (!Capacity || Capacity > (1u << 30)) {
+            return Result::EInvalidarg;
+        }
+
+        Release();
+
+        u32 Size{ 2 };
+        while (Size < Capacity) {
+            Size <<= 1;
+        }
+
+        m_Cells = (Cell*)Allocator::template Allocate<alignof(Cell)>(sizeof(Cell) * Size);
+        if (!m_Cells) {
+            return Result::ENomemory;
+        }
+
+        for (u32 I{ 0 }; I < Size; ++I) {
+            new (&m_Cells[I].Sequence) std::atomic<u32>(I);
+        }
+
+        m_Mask = Size - 1;
+        m_EnqueuePos.store(0, std::memory_order_relaxed);
+        m_DequeuePos.store(0, std::memory_order_relaxed);
+
+        return Result::Ok;
+    }
+
+    //Not thread safe, no producer or consumer may be active
+    void Release() {
+        if (!m_Cells) {
+            return;
+        }
+
+        const u32 End{ m_EnqueuePos.load(std::memory_order_relaxed) };
+        for (u32 Pos{ m_DequeuePos.load(std::memory_order_relaxed) }; Pos != End; ++Pos) {
+            ((T*)m_Cells[Pos & m_Mask].Storage)->~T();
+        }
+
+        Allocator::template Free<alignof(Cell)>(m_Cells);
+        m_Cells = nullptr;
+        m_Mask = 0;
+    }
+
+    //Returns false if the queue is full
+    template<typename... Args>
+    bool TryEmplace(Args&&... args) {
+        u32 Pos{ m_EnqueuePos.load(std::memory_order_relaxed) };
+        Cell* C{};
+
+        for (;;) {
+            C = &m_Cells[Pos & m_Mask];
+            const u32 Seq{ C->Sequence.load(std::memory_order_acquire) };
+            const s32 Diff{ (s32)(Seq - Pos) };
+
+            if (Diff == 0) {
+                if (m_EnqueuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (Diff < 0) {
+                return false;
+            }
+            else {
+                Pos = m_EnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        new (C->Storage) T(static_cast<Args&&>(args)...);
+        C->Sequence.store(Pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPush(const T& Value) { return TryEmplace(Value); }
+    bool TryPush(T&& Value) { return TryEmplace(static_cast<T&&>(Value)); }
+
+    //Returns false if the queue is empty
+    bool TryPop(T& Out) {
+        u32 Pos{ m_DequeuePos.load(std::memory_order_relaxed) };
+        Cell* C{};
+
+        for (;;) {
+            C = &m_Cells[Pos & m_Mask];
+            const u32 Seq{ C->Sequence.load(std::memory_order_acquire) };
+            const s32 Diff{ (s32)(Seq - (Pos + 1)) };
+
+            if (Diff == 0) {
+                if (m_DequeuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (Diff < 0) {
+                return false;
+            }
+            else {
+                Pos = m_DequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        T* Value{ (T*)C->Storage };
+        Out = Move(*Value);
+        Value->~T();
+        C->Sequence.store(Pos + m_Mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    constexpr u32 Capacity() const { return m_Cells ? m_Mask + 1 : 0; }
+
+private:
+    struct Cell {
+        std::atomic<u32>        Sequence;
+        alignas(T) u8           Storage[sizeof(T)];
+    };
+
+    alignas(CacheLineSize) Cell*            m_Cells{};
+    u32                                     m_Mask{};
+    alignas(CacheLineSize) std::atomic<u32> m_EnqueuePos{};
+    alignas(CacheLineSize) std::atomic<u32> m_DequeuePos{};
+};
+
+//Unbounded multi producer, single consumer queue (Vyukov). Push is one atomic exchange,
+//nodes come from MemAlloc. The consumer always keeps one node as the stub.
+template<typename T>
+class MpscQueue {
+public:
+    MpscQueue() {
+        m_Stub.Next.store(nullptr, std::memory_order_relaxed);
+        m_Head.store(&m_Stub, std::memory_order_relaxed);
+        m_Tail = &m_Stub;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    ~MpscQueue() {
+        while (Peek()) {
+            Pop();
+        }
+
+        FreeNode(m_Tail);
+    }
+
+    //Any thread. Returns false only if the node allocation failed
+    template<typename... Args>
+    bool Emplace(Args&&... args) {
+        Node* N{ (Node*)HeapAllocator::Allocate<alignof(Node)>(sizeof(Node)) };
+        if (!N) UNLIKELY {
+            return false;
+        }
+
+        N->Next.store(nullptr, std::memory_order_relaxed);
+        new (N->Storage) T(static_cast<Args&&>(args)...);
+
+        Node* Prev{ m_Head.exchange(N, std::memory_order_acq_rel) };
+        Prev->Next.store(N, std::memory_order_release);
+        return true;
+    }
+
+    bool Push(const T& Value) { return Emplace(Value); }
+    bool Push(T&& Value) { return Emplace(static_cast<T&&>(Value)); }
+
+    //Consumer only. May return nullptr while a producer is between its exchange and link
+    T* Peek() {
+        Node* Next{ m_Tail->Next.load(std::memory_order_acquire) };
+        return Next ? (T*)Next->Storage : nullptr;
+    }
+
+    //Consumer only
+    bool TryPop(T& Out) {
+        T* Front{ Peek() };
+        if (!Front) {
+            return false;
+        }
+
+        Out = Move(*Front);
+        Pop();
+        return true;
+    }
+
+    //Consumer only. Drops the element returned by Peek()
+    void Pop() {
+        Node* Tail{ m_Tail };
+        Node* Next{ Tail->Next.load(std::memory_order_acquire) };
+        if (!Next) {
+            return;
+        }
+
+        //The popped node becomes the new stub, its value is destroyed now
+        ((T*)Next->Storage)->~T();
+        m_Tail = Next;
+        FreeNode(Tail);
+    }
+
+    bool Empty() const {
+        return !m_Tail->Next.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*>      Next;
+        alignas(T) u8           Storage[sizeof(T)];
+    };
+
+    alignas(CacheLineSize) std::atomic<Node*>   m_Head{};   //Producers
+    alignas(CacheLineSize) Node*                m_Tail{};   //Consumer
+    Node                                        m_Stub{};
+
+    void FreeNode(Node* N) {
+        if (N != &m_Stub) {
+            HeapAllocator::Free<alignof(Node)>(N);
+        }
+    }
+};
+
+struct JobPriority {
+    enum Priority : u32 {
+        High = 0,
+        Normal,
+        Low,
+
+        Count
+    };
+};
+
+typedef void(*JobFunc)(void* Data);
+
+struct JobDecl {
+    JobFunc         Func;
+    void*           Data;
+};
+
+//Number of unfinished jobs, each job decrements it once it has run
+struct JobCounter {
+    std::atomic<u32>    Value{};
+
+    bool IsDone() const { return Value.load(std::memory_order_acquire) == 0; }
+};
+
+/// Starts WorkerCount worker threads, 0 means one per physical core besides the caller's.
+/// The calling thread is registered as job thread 0 and can help from WaitForCounter.
+CORE_API Result::Code InitializeJobSystem(u32 WorkerCount = 0);
+
+/// Joins all workers, jobs still queued are run on the calling thread
+CORE_API void ShutdownJobSystem();
+
+/// Worker threads plus the thread that initialized the job system, 1 if not initialized
+CORE_API u32 GetJobThreadCount();
+
+/// Index of the calling job thread, max_u32 for threads the job system does not own
+CORE_API u32 GetJobThreadIndex();
+
+/// Queues Count jobs. Counter is incremented by Count before any job can start.
+/// Jobs run inline when the job system is not initialized or the queues are full.
+CORE_API void RunJobs(const JobDecl* Jobs, u32 Count, JobCounter* Counter = nullptr,
+    JobPriority::Priority Priority = JobPriority::Normal);
+
+/// Runs queued jobs on the calling thread until Counter reaches zero
+CORE_API void WaitForCounter(JobCounter* Counter);
+
+inline void
+RunJob(JobFunc Func, void* Data, JobCounter* Counter = nullptr,
+    JobPriority::Priority Priority = JobPriority::Normal) {
+    const JobDecl Job{ Func, Data };
+    RunJobs(&Job, 1, Counter, Priority);
+}
+
+struct ScanMode {
+    enum Mode : u32 {
+        Exclusive = 0,
+        Inclusive,
+    };
+};
+
+namespace Detail {
+//Ranges are claimed with one atomic add, so uneven work balances itself across threads
+template<typename F>
+struct RangeContext {
+    F*                                      Func;
+    u64                                     Count;
+    u32                                     Batch;
+    alignas(CacheLineSize) std::atomic<u64> Next;
+
+    static void Run(void* Data) {
+        RangeContext& C{ *(RangeContext*)Data };
+        for (;;) {
+            const u64 Begin{ C.Next.fetch_add(C.Batch, std::memory_order_relaxed) };
+            if (Begin >= C.Count) {
+                return;
+            }
+
+            const u64 End{ Math::Min(Begin + C.Batch, C.Count) };
+            (*C.Func)((u32)Begin, (u32)End);
+        }
+    }
+};
+
+//Calls Func(Begin, End) for [0, Count) in ranges of exactly Batch elements (the last may be shorter)
+template<typename F>
+void RunRanges(u32 Count, u32 Batch, F& Func) {
+    if (!Count) {
+        return;
+    }
+
+    const u32 Ranges{ (Count + Batch - 1) / Batch };
+    const u32 Helpers{ Math::Min(Ranges, GetJobThreadCount()) - 1 };
+    if (!Helpers) {
+        for (u32 Begin{ 0 }; Begin < Count; Begin += Batch) {
+            Func(Begin, Math::Min(Begin + Batch, Count));
+        }
+        return;
+    }
+
+    RangeContext<F> Context{ &Func, Count, Batch };
+    Context.Next.store(0, std::memory_order_relaxed);
+
+    JobCounter Counter{};
+    for (u32 I{ 0 }; I < Helpers; ++I) {
+        RunJob(&RangeContext<F>::Run, &Context, &Counter, JobPriority::High);
+    }
+
+    RangeContext<F>::Run(&Context);
+    WaitForCounter(&Counter);
+}
+
+//About 8 ranges per job thread, never below MinBatch
+inline u32 PickBatch(u32 Count, u32 MinBatch) {
+    const u32 Target{ Count / (GetJobThreadCount() * 8) };
+    return Math::Max(Math::Max(Target, MinBatch), 1u);
+}
+
+template<typename T, typename KeyF>
+using SortKey = std::remove_cvref_t<std::invoke_result_t<KeyF&, const T&>>;
+}
+
+/// Calls Func(Begin, End) on the job threads for ranges covering [0, Count).
+/// MinBatch 0 picks the batch size from Count and the number of job threads.
+template<typename F>
+void ParallelForRange(u32 Count, F&& Func, u32 MinBatch = 0) {
+    Detail::RunRanges(Count, Detail::PickBatch(Count, MinBatch), Func);
+}
+
+/// Calls Func(Index) for every index in [0, Count)
+template<typename F>
+void ParallelFor(u32 Count, F&& Func, u32 MinBatch = 0) {
+    ParallelForRange(Count, [&Func](u32 Begin, u32 End) {
+        for (u32 I{ Begin }; I < End; ++I) {
+            Func(I);
+        }
+    }, MinBatch);
+}
+
+/// Calls Func(Value) for every element
+template<typename T, typename F>
+void ParallelFor(T* Data, u32 Count, F&& Func, u32 MinBatch = 0) {
+    ParallelForRange(Count, [Data, &Func](u32 Begin, u32 End) {
+        for (u32 I{ Begin }; I < End; ++I) {
+            Func(Data[I]);
+        }
+    }, MinBatch);
+}
+
+template<typename T, bool destruct, u32 Alignment, typename Allocator, typename F>
+void ParallelFor(Vector<T, destruct, Alignment, Allocator>& Values, F&& Func, u32 MinBatch = 0) {
+    ParallelFor(Values.Data(), Values.Size(), Func, MinBatch);
+}
+
+/// Reduces Map(Index) over [0, Count) with Op, which must be associative.
+/// Partial results are combined in index order, so Op need not be commutative.
+template<typename T, typename MapF, typename OpF>
+T ParallelReduce(u32 Count, const T& Identity, MapF&& Map, OpF&& Op, u32 MinBatch = 0) {
+    if (!Count) {
+        return Identity;
+    }
+
+    ScratchScope Scope{};
+
+    const u32 Batch{ Detail::PickBatch(Count, MinBatch) };
+    const u32 Ranges{ (Count + Batch - 1) / Batch };
+    T* Partials{ (T*)ScratchAlloc(sizeof(T) * Ranges, alignof(T)) };
+
+    auto Reduce{ [&](u32 Begin, u32 End) {
+        T Acc{ Map(Begin) };
+        for (u32 I{ Begin + 1 }; I < End; ++I) {
+            Acc = Op(Acc, Map(I));
+        }
+        new (&Partials[Begin / Batch]) T(Move(Acc));
+    } };
+    Detail::RunRanges(Count, Batch, Reduce);
+
+    T Result{ Identity };
+    for (u32 I{ 0 }; I < Ranges; ++I) {
+        Result = Op(Result, Partials[I]);
+        Partials[I].~T();
+    }
+
+    return Result;
+}
+
+template<typename T, typename OpF>
+T ParallelReduce(const T* Data, u32 Count, const T& Identity, OpF&& Op, u32 MinBatch = 0) {
+    return ParallelReduce(Count, Identity, [Data](u32 I) -> const T& { return Data[I]; }, Op, MinBatch);
+}
+
+/// Prefix scan of In into Out with Op, which must be associative. In and Out may alias.
+/// Block totals are scanned first, then each block is rescanned from its offset.
+template<typename T, typename OpF>
+void ParallelScan(const T* In, T* Out, u32 Count, const T& Identity, OpF&& Op,
+    ScanMode::Mode Mode = ScanMode::Exclusive, u32 MinBatch = 0) {
+    if (!Count) {
+        return;
+    }
+
+    ScratchScope Scope{};
+
+    const u32 Batch{ Detail::PickBatch(Count, MinBatch) };
+    const u32 Ranges{ (Count + Batch - 1) / Batch };
+    T* Offsets{ (T*)ScratchAlloc(sizeof(T) * Ranges, alignof(T)) };
+
+    auto Sum{ [&](u32 Begin, u32 End) {
+        T Acc{ In[Begin] };
+        for (u32 I{ Begin + 1 }; I < End; ++I) {
+            Acc = Op(Acc, In[I]);
+        }
+        new (&Offsets[Begin / Batch]) T(Move(Acc));
+    } };
+    Detail::RunRanges(Count, Batch, Sum);
+
+    T Running{ Identity };
+    for (u32 I{ 0 }; I < Ranges; ++I) {
+        T Total{ Move(Offsets[I]) };
+        Offsets[I] = Running;
+        Running = Op(Running, Total);
+    }
+
+    auto Scan{ [&](u32 Begin, u32 End) {
+        T Acc{ Offsets[Begin / Batch] };
+        for (u32 I{ Begin }; I < End; ++I) {
+            const T Value{ In[I] };
+            if (Mode == ScanMode::Inclusive) {
+                Acc = Op(Acc, Value);
+                Out[I] = Acc;
+            }
+            else {
+                Out[I] = Acc;
+                Acc = Op(Acc, Value);
+            }
+        }
+    } };
+    Detail::RunRanges(Count, Batch, Scan);
+
+    for (u32 I{ 0 }; I < Ranges; ++I) {
+        Offsets[I].~T();
+    }
+}
+
+/// Stable LSD radix sort on an unsigned 32 or 64 bit key returned by Key(Value).
+/// Histograms and scatters of each 8 bit digit run in parallel, digits that are the
+/// same for every element are skipped.
+template<typename T, typename KeyF>
+void ParallelSort(T* Data, u32 Count, KeyF&& Key, u32 MinBatch = 0) {
+    using K = Detail::SortKey<T, KeyF>;
+    static_assert(std::is_unsigned_v<K> && (sizeof(K) == 4 || sizeof(K) == 8),
+        "ParallelSort keys must be u32 or u64");
+    static_assert(std::is_trivially_copyable_v<T>,
+        "ParallelSort moves elements with plain copies");
+
+    if (Count < 2) {
+        return;
+    }
+
+    if (Count <= 32) {
+        for (u32 I{ 1 }; I < Count; ++I) {
+            const T Value{ Data[I] };
+            const K ValueKey{ Key(Value) };
+            u32 J{ I };
+            for (; J > 0 && Key(Data[J - 1]) > ValueKey; --J) {
+                Data[J] = Data[J - 1];
+            }
+            Data[J] = Value;
+        }
+        return;
+    }
+
+    T* Temp{ (T*)HeapAllocator::Allocate<alignof(T)>(sizeof(T) * Count) };
+    if (!Temp) {
+        LOG_ERROR("ParallelSort failed to allocate %u elements", Count);
+        return;
+    }
+
+    ScratchScope Scope{};
+
+    const u32 Batch{ Detail::PickBatch(Count, Math::Max(MinBatch, 1024u)) };
+    const u32 Ranges{ (Count + Batch - 1) / Batch };
+    u32* Histograms{ (u32*)ScratchAlloc(sizeof(u32) * 256 * Ranges, alignof(u32)) };
+
+    T* Src{ Data };
+    T* Dst{ Temp };
+
+    for (u32 Shift{ 0 }; Shift < sizeof(K) * 8; Shift += 8) {
+        auto Histogram{ [&](u32 Begin, u32 End) {
+            u32* H{ Histograms + (Begin / Batch) * 256 };
+            MemSet(H, 0, sizeof(u32) * 256);
+            for (u32 I{ Begin }; I < End; ++I) {
+                ++H[(Key(Src[I]) >> Shift) & 0xff];
+            }
+        } };
+        Detail::RunRanges(Count, Batch, Histogram);
+
+        // Turn per range counts into scatter offsets, digit major so the sort stays stable
+        u32 Running{ 0 };
+        bool Skip{ false };
+        for (u32 Digit{ 0 }; Digit < 256; ++Digit) {
+            const u32 Start{ Running };
+            for (u32 R{ 0 }; R < Ranges; ++R) {
+                const u32 N{ Histograms[R * 256 + Digit] };
+                Histograms[R * 256 + Digit] = Running;
+                Running += N;
+            }
+
+            if (Running - Start == Count) {
+                Skip = true;
+                break;
+            }
+        }
+
+        if (Skip) {
+            continue;
+        }
+
+        auto Scatter{ [&](u32 Begin, u32 End) {
+            u32* H{ Histograms + (Begin / Batch) * 256 };
+            for (u32 I{ Begin }; I < End; ++I) {
+                Dst[H[(Key(Src[I]) >> Shift) & 0xff]++] = Src[I];
+            }
+        } };
+        Detail::RunRanges(Count, Batch, Scatter);
+
+        T* Swap{ Src };
+        Src = Dst;
+        Dst = Swap;
+    }
+
+    if (Src != Data) {
+        MemCopy(Data, Src, sizeof(T) * Count);
+    }
+
+    HeapAllocator::Free<alignof(T)>(Temp);
+}
+
+/// Sorts u32 or u64 values in ascending order
+template<typename T>
+void ParallelSort(T* Data, u32 Count) {
+    ParallelSort(Data, Count, [](T Value) { return Value; });
+}
+
+template<typename T, bool destruct, u32 Alignment, typename Allocator, typename... Args>
+void ParallelSort(Vector<T, destruct, Alignment, Allocator>& Values, Args&&... args) {
+    ParallelSort(Values.Data(), Values.Size(), static_cast<Args&&>(args)...);
+}
+}
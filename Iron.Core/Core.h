@@ -1,5 +1,7 @@
 #pragma once
+#include <exception>
 #include <new>
+#include <type_traits>
 
 #if !(defined(_WIN32) || defined(_WIN64))
 #error "Non-Windows platforms are not supported!"
@@ -62,15 +64,45 @@ constexpr static u64 Fnv1A(const char* Str) {
     return Hash;
 }
 
+// Log calls below this level are compiled out, 0 = Debug ... 3 = Error. Fatal is always kept.
+// Shipping builds can define IRON_LOG_MIN_LEVEL=2 to drop Debug and Info.
+#ifndef IRON_LOG_MIN_LEVEL
 #ifdef _DEBUG
-#define LOG_DEBUG(x, ...) ::Iron::Log(::Iron::LogLevel::Debug, __FILE__, __LINE__, x, __VA_ARGS__)
+#define IRON_LOG_MIN_LEVEL 0
 #else
-#define LOG_DEBUG(x, ...)
+#define IRON_LOG_MIN_LEVEL 1
 #endif
-#define LOG_INFO(x, ...) ::Iron::Log(::Iron::LogLevel::Info, __FILE__, __LINE__, x, __VA_ARGS__)
-#define LOG_WARNING(x, ...) ::Iron::Log(::Iron::LogLevel::Warning, __FILE__, __LINE__, x, __VA_ARGS__)
-#define LOG_ERROR(x, ...) ::Iron::Log(::Iron::LogLevel::Error, __FILE__, __LINE__, x, __VA_ARGS__)
-#define LOG_FATAL(x, ...) ::Iron::Log(::Iron::LogLevel::Fatal, __FILE__, __LINE__, x, __VA_ARGS__)
+#endif
+
+// Every call site owns a constant initialized LogSite, the binary log refers to it by id
+#define IRON_LOG(Level, x, ...) do { \
+    if (const ::Iron::LogMode::Mode IronLogMode_{ ::Iron::GetLogMode(Level) }) { \
+        static ::Iron::LogSite IronLogSite_{ Level, __LINE__, __FILE__, x }; \
+        ::Iron::LogAt(IronLogMode_, IronLogSite_, __VA_ARGS__); \
+    } \
+} while (0)
+
+#if IRON_LOG_MIN_LEVEL <= 0
+#define LOG_DEBUG(x, ...) IRON_LOG(::Iron::LogLevel::Debug, x, __VA_ARGS__)
+#else
+#define LOG_DEBUG(x, ...) ((void)0)
+#endif
+#if IRON_LOG_MIN_LEVEL <= 1
+#define LOG_INFO(x, ...) IRON_LOG(::Iron::LogLevel::Info, x, __VA_ARGS__)
+#else
+#define LOG_INFO(x, ...) ((void)0)
+#endif
+#if IRON_LOG_MIN_LEVEL <= 2
+#define LOG_WARNING(x, ...) IRON_LOG(::Iron::LogLevel::Warning, x, __VA_ARGS__)
+#else
+#define LOG_WARNING(x, ...) ((void)0)
+#endif
+#if IRON_LOG_MIN_LEVEL <= 3
+#define LOG_ERROR(x, ...) IRON_LOG(::Iron::LogLevel::Error, x, __VA_ARGS__)
+#else
+#define LOG_ERROR(x, ...) ((void)0)
+#endif
+#define LOG_FATAL(x, ...) IRON_LOG(::Iron::LogLevel::Fatal, x, __VA_ARGS__)
 #define LOG_RESULT(x) ::Iron::LogError(x, __FILE__, __LINE__)
 
 #ifndef UNLIKELY
@@ -106,6 +138,7 @@ struct Result {
         EFrameGraph,
         EShaderError,
         EInvalidData,
+        ECancelled,
 
         Count,
     };
@@ -161,8 +194,8 @@ Generation(TypeId id) {
 
 constexpr inline TypeId
 NextGeneration(TypeId id) {
-    const u32 generation{ Generation(id) };
-    return  (generation << IndexBits) | Index(id);
+    const u32 generation{ (Generation(id) + 1) & GenerationMask };
+    return (generation << IndexBits) | Index(id);
 }
 
 constexpr inline bool
@@ -176,20 +209,493 @@ MakeHandle(u32 index, u32 generation) {
 }
 }//Id namespace
 
+constexpr inline u32 CacheLineSize{ 64 };
+
+struct AllocatorBackend {
+    enum Type : u32 {
+        Crt = 0,
+        Pool,
+        Count,
+    };
+};
+
+struct MemTag {
+    enum Tag : u32 {
+        General = 0,
+        Core,
+        RHI,
+        FrameGraph,
+        Assets,
+        Scripting,
+        Audio,
+        Static,     // Kept until the process exits, left out of the leak report
+        Count,
+    };
+};
+
+struct MemTagStats {
+    u64         LiveBytes;
+    u64         PeakBytes;
+    u64         LiveAllocations;
+    u64         TotalAllocations;
+    u64         Budget; // 0 if no budget is set
+};
+
+typedef void(*MemBudgetCallback)(MemTag::Tag Tag, u64 LiveBytes, u64 Budget, void* UserData);
+
 CORE_API void* MemAlloc(size_t Size);
 CORE_API void MemFree(void* Block);
 CORE_API void MemSet(void* Dst, u8 Value, size_t Size);
 CORE_API void MemCopy(void* Dst, const void* Src, size_t Size);
 CORE_API void MemCopyS(void* Dst, const void* Src, size_t DstSize, size_t SrcSize);
 
+/// Tagged allocations are accounted to their tag, untagged ones to MemTag::General.
+/// A block MUST be freed with the same tag it was allocated with, debug builds check it.
+CORE_API void* MemAlloc(size_t Size, MemTag::Tag Tag);
+CORE_API void MemFree(void* Block, MemTag::Tag Tag);
+
+/// Usable size of a block returned by MemAlloc
+CORE_API size_t MemSize(const void* Block);
+
+/// Alignment every MemAlloc block is guaranteed to have
+constexpr inline u32 MemDefaultAlignment{ 16 };
+
+/// Alignment must be a power of two. Blocks MUST be freed with MemFreeAligned.
+CORE_API void* MemAllocAligned(size_t Size, size_t Alignment);
+CORE_API void* MemAllocAligned(size_t Size, size_t Alignment, MemTag::Tag Tag);
+CORE_API void MemFreeAligned(void* Block);
+CORE_API void MemFreeAligned(void* Block, MemTag::Tag Tag);
+
+/// Reserves address space without backing memory, pages must be committed before use
+CORE_API void* VirtualReserve(u64 Size);
+CORE_API bool VirtualCommit(void* Address, u64 Size);
+CORE_API void VirtualDecommit(void* Address, u64 Size);
+CORE_API void VirtualRelease(void* Address, u64 Size);
+CORE_API u64 GetVirtualPageSize();
+
+/// Backend serving MemAlloc/MemFree, selected once on the first allocation.
+/// Defaults to the pool allocator, set IRON_ALLOCATOR=crt to use the CRT heap instead.
+CORE_API AllocatorBackend::Type GetAllocatorBackend();
+
+CORE_API const char* GetMemTagName(MemTag::Tag Tag);
+/// Sums the counters of every thread, slow enough to keep out of per allocation paths
+CORE_API MemTagStats GetMemTagStats(MemTag::Tag Tag);
+
+/// Callback fires once each time the live bytes of Tag rise above Budget. Threads report
+/// their bytes in steps of 256KB, so the check may fire that much late per thread.
+/// A Budget of 0 disables the check.
+CORE_API void SetMemTagBudget(MemTag::Tag Tag, u64 Budget, MemBudgetCallback Callback, void* UserData = nullptr);
+
+/// Logs the live allocations of every tag but Static, should be called at shutdown
+CORE_API void ReportMemoryLeaks();
+
+constexpr inline u32 MaxCpuCores{ 256 };
+
+struct CpuCore {
+    u64         LogicalMask;        // Logical processors of this core within Group
+    u16         Group;
+    u8          LogicalCount;       // 2 or more with SMT
+    u8          EfficiencyClass;    // Higher is faster, all equal on non hybrid CPUs
+    u32         NumaNode;
+};
+
+struct CpuCache {
+    u32         Size;               // Bytes per cache instance, 0 if not reported
+    u32         LineSize;
+    u32         Count;              // Instances on the machine
+};
+
+struct CpuTopology {
+    u32         LogicalProcessors;
+    u32         PhysicalCores;
+    u32         PerformanceCores;   // Cores in the highest efficiency class
+    u32         EfficiencyCores;
+    u32         NumaNodes;
+    bool        Hybrid;
+    CpuCache    L1Data;
+    CpuCache    L2;
+    CpuCache    L3;
+    CpuCore     Cores[MaxCpuCores]; // Fastest first, PhysicalCores entries are valid
+};
+
+struct ThreadPriority {
+    enum Priority : u32 {
+        Lowest = 0,
+        BelowNormal,
+        Normal,
+        AboveNormal,
+        Highest,
+        TimeCritical,
+    };
+};
+
+/// Queried once on first use
+CORE_API const CpuTopology& GetCpuTopology();
+
+/// The following apply to the calling thread
+CORE_API void SetCurrentThreadName(const char* Name);
+CORE_API bool SetCurrentThreadAffinity(u16 Group, u64 Mask);
+CORE_API bool SetCurrentThreadPriority(ThreadPriority::Priority Priority);
+
+/// Restricts the calling thread to the logical processors of one physical core,
+/// CoreIndex indexes CpuTopology::Cores so low indices are the fast cores
+CORE_API bool PinCurrentThreadToCore(u32 CoreIndex);
+
+struct LogMode {
+    enum Mode : u32 {
+        Off = 0,
+        Text,
+        Binary,
+        BinaryAndText,  // Binary, and text for Fatal or the sinks kept with the binary log
+    };
+};
+
+struct LogSite {
+    LogLevel::Level Level;
+    u32             Line;
+    const char*     File;
+    const char*     Format;
+    u64             Id;         // Binary log generation and site id, written by the log only
+};
+
+struct LogArgType {
+    enum Type : u8 {
+        None = 0,
+        S32,
+        U32,
+        S64,
+        U64,
+        F64,
+        Pointer,
+        String,     // u16 length followed by the characters, no terminator
+    };
+};
+
+/// Arguments of one binary log event, strings are truncated to what still fits
+struct LogArgWriter {
+    u8      Data[480];
+    u32     Size{ 0 };
+
+    void Put(LogArgType::Type Type, const void* Value, u32 Bytes) {
+        if (Size + 1 + Bytes > sizeof(Data)) {
+            return;
+        }
+
+        Data[Size++] = Type;
+        for (u32 I{ 0 }; I < Bytes; ++I) {
+            Data[Size++] = ((const u8*)Value)[I];
+        }
+    }
+
+    // Wide strings are narrowed, characters outside of ASCII become '?'
+    template<typename C>
+    void PutString(const C* Str) {
+        if (!Str) {
+            PutString("(null)");
+            return;
+        }
+
+        if (Size + 1 + sizeof(u16) > sizeof(Data)) {
+            return;
+        }
+
+        u16 Length{ 0 };
+        const u32 Max{ (u32)sizeof(Data) - Size - 1 - (u32)sizeof(u16) };
+        while (Str[Length] && Length < Max) {
+            ++Length;
+        }
+
+        Put(LogArgType::String, &Length, sizeof(u16));
+        for (u16 I{ 0 }; I < Length; ++I) {
+            Data[Size++] = sizeof(C) == 1 || (u32)Str[I] < 0x80 ? (u8)Str[I] : (u8)'?';
+        }
+    }
+};
+
+// Overloads follow the varargs promotions, small integers arrive as int and float as double
+inline void EncodeLogArg(LogArgWriter& W, int V) { W.Put(LogArgType::S32, &V, 4); }
+inline void EncodeLogArg(LogArgWriter& W, unsigned V) { W.Put(LogArgType::U32, &V, 4); }
+inline void EncodeLogArg(LogArgWriter& W, long V) { W.Put(sizeof(V) == 4 ? LogArgType::S32 : LogArgType::S64, &V, sizeof(V)); }
+inline void EncodeLogArg(LogArgWriter& W, unsigned long V) { W.Put(sizeof(V) == 4 ? LogArgType::U32 : LogArgType::U64, &V, sizeof(V)); }
+inline void EncodeLogArg(LogArgWriter& W, long long V) { W.Put(LogArgType::S64, &V, 8); }
+inline void EncodeLogArg(LogArgWriter& W, unsigned long long V) { W.Put(LogArgType::U64, &V, 8); }
+inline void EncodeLogArg(LogArgWriter& W, double V) { W.Put(LogArgType::F64, &V, 8); }
+inline void EncodeLogArg(LogArgWriter& W, const char* V) { W.PutString(V); }
+inline void EncodeLogArg(LogArgWriter& W, char* V) { W.PutString(V); }
+inline void EncodeLogArg(LogArgWriter& W, const wchar_t* V) { W.PutString(V); }
+inline void EncodeLogArg(LogArgWriter& W, wchar_t* V) { W.PutString(V); }
+
+// Scoped enums aren't promoted, they are recorded as their underlying type. Plain enums
+// take the int overload like any other promoted integer.
+template<typename T> requires (std::is_enum_v<T> && !std::is_convertible_v<T, int>)
+inline void EncodeLogArg(LogArgWriter& W, T V) { EncodeLogArg(W, +(std::underlying_type_t<T>)V); }
+
+template<typename T>
+inline void EncodeLogArg(LogArgWriter& W, T* V) {
+    const u64 Address{ (u64)V };
+    W.Put(LogArgType::Pointer, &Address, 8);
+}
+
+/// Binary log file layout. The header is followed by records, each 8 byte aligned.
+/// A record with Size 0 ends the log, one with Type None was never completed.
+struct BinaryLog {
+    constexpr static u32 Magic{ 0x474F4C49 }; // "ILOG"
+    constexpr static u32 Version{ 2 };
+
+    struct Header {
+        u32     Magic;
+        u32     Version;
+        u64     TickFrequency;
+        u64     StartTicks;
+        u64     StartTime;      // FILETIME at StartTicks
+        u64     Dropped;        // Events and sites that did not fit, final once the log is closed
+    };
+
+    struct RecordType {
+        enum Type : u32 {
+            None = 0,
+            Site,
+            Event,
+        };
+    };
+
+    struct Record {
+        u32     Size;
+        u32     Type;           // Written last
+    };
+
+    // Followed by FileLength then FormatLength characters
+    struct Site {
+        Record  Header;
+        u32     Id;
+        u32     Level;
+        u32     Line;
+        u16     FileLength;
+        u16     FormatLength;
+    };
+
+    // Followed by the encoded arguments
+    struct Event {
+        Record  Header;
+        u32     Site;
+        u32     ThreadId;
+        u64     Ticks;
+    };
+};
+
+/// Off when the level is disabled, Binary or BinaryAndText while a binary log is open
+CORE_API LogMode::Mode GetLogMode(LogLevel::Level Level);
+CORE_API void LogBinary(LogSite& Site, const LogArgWriter& Args);
+
+/// Events of every LOG_* call go to Path instead of the text sinks until closed. Fatal events
+/// are written to both, sinks added with LogSinkFlags::KeepWithBinaryLog keep their messages.
+/// Capacity is reserved up front, events past it are dropped and counted in Header::Dropped.
+CORE_API Result::Code OpenBinaryLog(const char* Path, u64 Capacity = 64ull * 1024 * 1024);
+CORE_API void CloseBinaryLog();
+
 CORE_API void Log(LogLevel::Level Level, const char* File, int Line, const char* Msg, ...);
+
+template<typename... Args>
+void LogAt(LogMode::Mode Mode, LogSite& Site, Args... args) {
+    if (Mode != LogMode::Text) {
+        LogArgWriter W;
+        (EncodeLogArg(W, args), ...);
+        LogBinary(Site, W);
+        if (Mode == LogMode::Binary) {
+            return;
+        }
+    }
+
+    Log(Site.Level, Site.File, (int)Site.Line, Site.Format, args...);
+}
+
 CORE_API void EnableLogLevel(LogLevel::Level Level, bool Enable);
 CORE_API void EnableLogIncludePath(bool Enable);
 CORE_API void LogError(Result::Code Code, const char* File, int Line);
 
+/// Moves sink output to a background thread, Log only formats and queues the line.
+/// Without a writer every line is written synchronously.
+CORE_API Result::Code StartLogWriter();
+/// Writes everything still queued before returning
+CORE_API void StopLogWriter();
+/// Blocks until every line logged before the call has been written, fatal logs always flush
+CORE_API void FlushLog();
+
+/// Replaces file atomically through FileWriter, missing directories are created
 CORE_API Result::Code WriteFile(const char* file, const u8* const data, u64 length);
 CORE_API Result::Code ReadFile(const char* file, u8*& data, u64& length);
 
+/// Creates the missing parent directories of every file, each directory is only touched once.
+/// For tools writing many files into the same few directories.
+CORE_API Result::Code CreateParentDirectories(const char* const* Files, u32 Count);
+
+struct FileWriteFlags {
+    enum Flags : u32 {
+        None = 0,
+        CreateDirectories = 1 << 0,     // Create missing parent directories when the open fails
+        NoFlush = 1 << 1,               // Skip flushing to disk before the rename, for outputs that can be rebuilt
+    };
+};
+
+/// Buffered writer that replaces Path atomically. Everything goes to a temporary file next to
+/// Path, unique per writer, Commit flushes it and renames it over Path. A crash or a writer
+/// closed without Commit leaves Path untouched. The first failure sticks, later writes and
+/// Commit return it.
+class FileWriter {
+public:
+    constexpr static u32 DefaultBufferSize{ 256 * 1024 };
+
+    FileWriter() = default;
+    FileWriter(const FileWriter&) = delete;
+    FileWriter& operator=(const FileWriter&) = delete;
+
+    ~FileWriter() {
+        Abort();
+    }
+
+    CORE_API Result::Code Open(const char* Path, u32 Flags = FileWriteFlags::None,
+        u32 BufferSize = DefaultBufferSize);
+    /// Writes as large as the buffer skip it
+    CORE_API Result::Code Write(const void* Data, u64 Size);
+    CORE_API Result::Code Commit();
+    /// Drops the temporary file
+    CORE_API void Abort();
+
+    constexpr bool IsOpen() const { return m_File != nullptr; }
+    constexpr u64 Size() const { return m_Written + m_Used; }
+    /// OS error code of the first failure
+    constexpr u32 GetSystemError() const { return m_SystemError; }
+
+private:
+    Result::Code Flush();
+    Result::Code WriteDirect(const u8* Data, u64 Size);
+    Result::Code Fail(Result::Code Code);
+
+    void*           m_File{ nullptr };
+    u8*             m_Buffer{ nullptr };
+    u32             m_Capacity{ 0 };
+    u32             m_Used{ 0 };
+    u64             m_Written{ 0 };
+    u32             m_Flags{ 0 };
+    Result::Code    m_Error{ Result::Ok };
+    u32             m_SystemError{ 0 };
+    char            m_Path[IRON_MAX_PATH]{};
+    char            m_TempPath[IRON_MAX_PATH]{};
+};
+
+struct FileAccess {
+    enum Pattern : u32 {
+        Normal = 0,
+        Sequential,     // Read front to back once, the OS reads ahead aggressively
+        Random,         // Scattered reads, read ahead is turned off
+
+        Count,
+    };
+};
+
+/// Read only view of a whole file. The data is paged in from the file cache on first touch,
+/// nothing is copied to the heap. Unmapped when closed or destroyed.
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& Other) noexcept
+        : m_Data(Other.m_Data), m_Size(Other.m_Size) {
+        Other.m_Data = nullptr;
+        Other.m_Size = 0;
+    }
+
+    MappedFile& operator=(MappedFile&& Other) noexcept {
+        if (this != &Other) {
+            Close();
+            m_Data = Other.m_Data;
+            m_Size = Other.m_Size;
+            Other.m_Data = nullptr;
+            Other.m_Size = 0;
+        }
+        return *this;
+    }
+
+    ~MappedFile() {
+        Close();
+    }
+
+    /// Empty files can not be mapped and fail like ReadFile
+    CORE_API Result::Code Open(const char* File, FileAccess::Pattern Access = FileAccess::Normal);
+    CORE_API void Close();
+    /// Starts reading the range into memory in the background, e.g. right before it is used
+    CORE_API void Prefetch(u64 Offset, u64 Length) const;
+
+    constexpr const u8* Data() const { return m_Data; }
+    constexpr u64 Size() const { return m_Size; }
+    constexpr bool IsOpen() const { return m_Data != nullptr; }
+
+private:
+    const u8*   m_Data{ nullptr };
+    u64         m_Size{ 0 };
+};
+
+struct IoPriority {
+    enum Priority : u32 {
+        Critical = 0,   // Never held back by the frame budget
+        High,
+        Normal,
+        Low,
+
+        Count,
+    };
+};
+
+struct IoCompletion {
+    Result::Code    Code;       // ECancelled when cancelled, ELoadfile when the read failed
+    u8*             Buffer;     // When the queue allocated it the callback owns it, release with MemFree
+    u64             Bytes;
+    void*           UserData;
+};
+
+using IoCallback = void(*)(const IoCompletion& Completion);
+
+struct IoReadInfo {
+    const char*             Path;       // Copied on submit
+    u64                     Offset;
+    u64                     Size;       // 0 reads to the end of the file, needs a null Buffer
+    u8*                     Buffer;     // Null lets the queue allocate the buffer
+    IoCallback              Callback;
+    void*                   UserData;
+    IoPriority::Priority    Priority;
+};
+
+/// Starts the IO thread. Reads are overlapped, higher priorities are issued first and large
+/// reads are split into chunks so priorities, cancellation and the budget apply in between.
+CORE_API Result::Code StartIoQueue();
+/// Cancels everything pending, waits for reads in flight and joins the IO thread
+CORE_API void StopIoQueue();
+/// Returns the read id, 0 if the queue isn't running or Info is invalid. Callbacks run on
+/// the IO thread, anything more than a few copies belongs in a job.
+CORE_API u64 SubmitRead(const IoReadInfo& Info);
+/// Submits all reads under one lock and wakes the IO thread once, Ids may be null
+CORE_API void SubmitReads(const IoReadInfo* Infos, u32 Count, u64* Ids);
+/// The callback still runs, with ECancelled. False if the read had already completed.
+CORE_API bool CancelRead(u64 Id);
+/// Starts a new frame for the bandwidth budget, bytes issued below Critical priority
+/// per frame are capped by BudgetBytes, 0 is unlimited
+CORE_API void BeginIoFrame(u64 BudgetBytes);
+
+using FileWatchCallback = void(*)(const char* Path, void* UserData);
+
+/// Watches File from a background thread, started by the first watch. Changes are only
+/// reported through DispatchFileChanges, callbacks run on the thread calling it.
+/// Returns 0 if the file's directory can not be watched.
+CORE_API u32 WatchFile(const char* File, FileWatchCallback Callback, void* UserData = nullptr);
+CORE_API void UnwatchFile(u32 Id);
+/// Runs the callbacks of files that changed and then stayed untouched for a moment, so an
+/// editor saving in several writes reports once. Meant to be called at a frame boundary.
+CORE_API void DispatchFileChanges();
+/// Drops every watch and joins the watcher thread
+CORE_API void StopFileWatcher();
+
 template<typename T>
 static T&& Move(T& Obj) {
     return static_cast<T&&>(Obj);
@@ -246,45 +752,130 @@ void SafeRelease(T*& ptr) {
     }
 }
 
+struct LogMessage {
+    LogLevel::Level Level;
+    u32             Length;     // Of Text, including the trailing newline
+    u64             Time;       // UTC FILETIME of the Log call
+    const char*     Text;       // "File:Line Message\n", the level tag is left to the sink
+};
+
+/// Output of the text log. Calls are serialized by the log, from its writer thread or from
+/// Log itself while no writer runs. Sinks must not log.
+class ILogSink : public IObjectBase {
+public:
+    virtual void Write(const LogMessage& Message) = 0;
+
+    /// Force is false after every batch the writer drained, buffering sinks may hold on to
+    /// their data. Returns true while data is still buffered, the writer then calls again soon.
+    virtual bool Flush(bool Force) = 0;
+};
+
+/// Keeps the most recent messages in memory, e.g. for crash reports
+class ILogRingSink : public ILogSink {
+public:
+    /// Copies the kept messages oldest first, null terminated. Returns the length copied.
+    virtual u32 CopyRecent(char* Buffer, u32 Size) = 0;
+};
+
+struct LogFileRotation {
+    u64     MaxBytes;       // 0 disables size based rotation
+    u32     MaxSeconds;     // 0 disables time based rotation
+    u32     KeepFiles;      // Rotated files kept as Name.1.ext ... Name.N.ext
+};
+
+CORE_API ILogSink* CreateConsoleLogSink();
+/// An existing file at Path is rotated away first
+CORE_API ILogSink* CreateFileLogSink(const char* Path, const LogFileRotation& Rotation);
+CORE_API ILogRingSink* CreateRingLogSink(u32 MessageCount);
+
+struct LogSinkFlags {
+    enum Flags : u32 {
+        None = 0,
+        KeepWithBinaryLog = 1 << 0,     // Still receives every message while a binary log is open
+    };
+};
+
+/// The log takes ownership of the sink, also when adding it fails. It only receives
+/// messages at or above MinLevel.
+/// While no sink is added the log writes to the console.
+CORE_API Result::Code AddLogSink(ILogSink* Sink, LogLevel::Level MinLevel = LogLevel::Debug,
+    u32 Flags = LogSinkFlags::None);
+/// Flushes and releases the sink
+CORE_API void RemoveLogSink(ILogSink* Sink);
+CORE_API void RemoveAllLogSinks();
+
+/// Writes into a fixed buffer, or into its own growing buffer when created without one.
+/// Values are stored little endian as they are in memory, every engine target is little endian.
+/// Writes that don't fit fail and leave the stream failed.
 class StreamWriter {
 public:
     StreamWriter() = default;
 
-    StreamWriter(u8* blob, u32 size)
-        : m_Stream(nullptr), m_Offset(0), m_Size(0) {
+    StreamWriter(u8* blob, u32 size) {
         Initialize(blob, size);
     }
 
+    StreamWriter(const StreamWriter&) = delete;
+    StreamWriter& operator=(const StreamWriter&) = delete;
+
+    ~StreamWriter() {
+        if (m_Owned) {
+            MemFree(m_Stream);
+        }
+    }
+
     bool Initialize(u8* blob, u32 size) {
         if (!(blob && size)) {
             return false;
         }
 
+        if (m_Owned) {
+            MemFree(m_Stream);
+        }
+
         m_Stream = blob;
         m_Offset = 0;
         m_Size = size;
+        m_Owned = false;
+        m_Failed = false;
 
         return true;
     }
 
     template<typename T>
-    void Write(const T& value) {
-        constexpr u32 size{ sizeof(value) };
-        if (m_Offset + size > m_Size) {
-            return;
-        }
-
-        *m_Stream[m_Offset] = value;
-        m_Offset += size;
+    bool Write(const T& value) {
+        return Write(&value, sizeof(value));
     }
 
-    void Write(const u8* const buffer, u32 size) {
-        if (m_Offset + size > m_Size) {
-            return;
+    bool Write(const void* const buffer, u64 size) {
+        if (!Reserve(size)) {
+            return false;
         }
 
         MemCopy(&m_Stream[m_Offset], buffer, size);
-        m_Offset += size;
+        m_Offset += (u32)size;
+        return true;
+    }
+
+    /// LEB128, 7 bits per byte
+    bool WriteVarU64(u64 value) {
+        u8 bytes[10];
+        u32 count{ 0 };
+        do {
+            bytes[count] = (u8)(value & 0x7f);
+            value >>= 7;
+            if (value) {
+                bytes[count] |= 0x80;
+            }
+            ++count;
+        } while (value);
+
+        return Write(bytes, count);
+    }
+
+    /// Zigzag encoded so small negative values stay short
+    bool WriteVarS64(s64 value) {
+        return WriteVarU64(((u64)value << 1) ^ (u64)(value >> 63));
     }
 
     void SetPos(u32 offset) {
@@ -295,6 +886,10 @@ public:
         m_Offset = offset;
     }
 
+    constexpr const u8* Data() const {
+        return m_Stream;
+    }
+
     constexpr u32 Offset() const {
         return m_Offset;
     }
@@ -303,48 +898,241 @@ public:
         return m_Size;
     }
 
+    constexpr bool Failed() const {
+        return m_Failed;
+    }
+
 private:
-    u8*         m_Stream;
-    u32         m_Offset;
-    u32         m_Size;
+    bool Reserve(u64 size) {
+        if (m_Failed) {
+            return false;
+        }
+
+        if (m_Offset + size <= m_Size) {
+            return true;
+        }
+
+        if ((m_Stream && !m_Owned) || m_Offset + size > max_u32) {
+            m_Failed = true;
+            return false;
+        }
+
+        u64 capacity{ m_Size ? m_Size : 256 };
+        while (capacity < m_Offset + size) {
+            capacity *= 2;
+        }
+        capacity = capacity > max_u32 ? max_u32 : capacity;
+
+        u8* const stream{ (u8*)MemAlloc(capacity) };
+        if (!stream) {
+            m_Failed = true;
+            return false;
+        }
+
+        if (m_Stream) {
+            MemCopy(stream, m_Stream, m_Offset);
+            MemFree(m_Stream);
+        }
+
+        m_Stream = stream;
+        m_Size = (u32)capacity;
+        m_Owned = true;
+        return true;
+    }
+
+    u8*         m_Stream{ nullptr };
+    u32         m_Offset{ 0 };
+    u32         m_Size{ 0 };
+    bool        m_Owned{ false };
+    bool        m_Failed{ false };
 };
 
+/// Bounds checked reads of data written by StreamWriter. A read past the end fails, leaves
+/// the value untouched and makes every later read fail too, so callers may check once at the end.
 class StreamReader {
 public:
     StreamReader() = default;
 
-    StreamReader(const u8* blob)
-        : m_Stream(blob), m_Position(blob) {
+    StreamReader(const u8* blob, u64 size)
+        : m_Stream(blob), m_Position(blob), m_End(blob ? blob + size : blob) {
+    }
+
+    template<typename T>
+    bool Read(T& value) {
+        return Read(&value, sizeof(value));
     }
 
+    /// Zero when the read fails
     template<typename T>
     T Read() {
-        const T value{ *((T*)m_Position) };
-        m_Position += sizeof(T);
+        T value{};
+        Read(value);
         return value;
     }
 
-    void Read(u8* buffer, size_t length) {
-        MemCopy(buffer, m_Position, length);
+    bool Read(void* buffer, u64 length) {
+        const u8* const data{ Take(length) };
+        if (!data) {
+            return false;
+        }
+
+        MemCopy(buffer, data, length);
+        return true;
+    }
+
+    bool ReadVarU64(u64& value) {
+        u64 result{ 0 };
+        for (u32 shift{ 0 }; shift < 64; shift += 7) {
+            const u8* const byte{ Take(1) };
+            if (!byte) {
+                return false;
+            }
+
+            // The tenth byte only holds the top bit
+            if (shift == 63 && *byte > 1) {
+                break;
+            }
+
+            result |= (u64)(*byte & 0x7f) << shift;
+            if (!(*byte & 0x80)) {
+                value = result;
+                return true;
+            }
+        }
+
+        // Longer than any u64 StreamWriter writes
+        m_Failed = true;
+        return false;
+    }
+
+    bool ReadVarS64(s64& value) {
+        u64 encoded{ 0 };
+        if (!ReadVarU64(encoded)) {
+            return false;
+        }
+
+        value = (s64)(encoded >> 1) ^ -(s64)(encoded & 1);
+        return true;
+    }
+
+    /// Returns the next length bytes in place and moves past them, null if there are fewer left
+    const u8* Take(u64 length) {
+        if (m_Failed || length > Remaining()) {
+            m_Failed = true;
+            return nullptr;
+        }
+
+        const u8* const data{ m_Position };
         m_Position += length;
+        return data;
     }
 
-    constexpr void Skip(size_t offset) {
-        m_Position += offset;
+    bool Skip(u64 length) {
+        return Take(length) != nullptr;
     }
 
-    constexpr const u8* const Start() const { return m_Stream; }
-    constexpr const u8* const Position() const { return m_Position; }
-    constexpr size_t Offset() const { return m_Position - m_Stream; }
+    constexpr const u8* Start() const { return m_Stream; }
+    constexpr const u8* Position() const { return m_Position; }
+    constexpr u64 Offset() const { return (u64)(m_Position - m_Stream); }
+    constexpr u64 Remaining() const { return (u64)(m_End - m_Position); }
+    constexpr bool Failed() const { return m_Failed; }
+
+private:
+    const u8*   m_Stream{ nullptr };
+    const u8*   m_Position{ nullptr };
+    const u8*   m_End{ nullptr };
+    bool        m_Failed{ false };
+};
+
+struct ScratchMarker {
+    void*       Block;
+    u64         Offset;
+};
+
+/// Allocates from the calling thread's scratch memory, there is no individual free.
+/// Everything allocated after a marker is released at once by RewindScratch.
+CORE_API void* ScratchAlloc(u64 Size, u64 Alignment = MemDefaultAlignment);
+CORE_API ScratchMarker GetScratchMarker();
+CORE_API void RewindScratch(const ScratchMarker& Marker);
+
+//Releases every scratch allocation made during its lifetime
+class ScratchScope {
+public:
+    ScratchScope() : m_Marker(GetScratchMarker()) {}
+    ~ScratchScope() { RewindScratch(m_Marker); }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
 
 private:
-    const u8* const m_Stream;
-    const u8*       m_Position;
+    ScratchMarker   m_Marker;
+};
+
+//Container allocator policies
+struct HeapAllocator {
+    template<u32 Alignment>
+    static void* Allocate(size_t Size) {
+        if constexpr (Alignment > MemDefaultAlignment) {
+            return MemAllocAligned(Size, Alignment);
+        }
+        else {
+            return MemAlloc(Size);
+        }
+    }
+
+    template<u32 Alignment>
+    static void Free(void* Block) {
+        if constexpr (Alignment > MemDefaultAlignment) {
+            MemFreeAligned(Block);
+        }
+        else {
+            MemFree(Block);
+        }
+    }
+};
+
+//Accounts every block to Tag, e.g. MemTag::Static for tables that live as long as the process
+template<MemTag::Tag Tag>
+struct TaggedAllocator {
+    template<u32 Alignment>
+    static void* Allocate(size_t Size) {
+        if constexpr (Alignment > MemDefaultAlignment) {
+            return MemAllocAligned(Size, Alignment, Tag);
+        }
+        else {
+            return MemAlloc(Size, Tag);
+        }
+    }
+
+    template<u32 Alignment>
+    static void Free(void* Block) {
+        if constexpr (Alignment > MemDefaultAlignment) {
+            MemFreeAligned(Block, Tag);
+        }
+        else {
+            MemFree(Block, Tag);
+        }
+    }
+};
+
+struct ScratchAllocator {
+    template<u32 Alignment>
+    static void* Allocate(size_t Size) {
+        return ScratchAlloc(Size, Alignment);
+    }
+
+    //Reclaimed when the enclosing ScratchScope ends
+    template<u32 Alignment>
+    static void Free(void*) {}
 };
 
 //Important! No constructors/destructors will be called!
-template<typename T, bool destruct = true>
+//Storage is aligned to Alignment, which follows alignof(T) unless overridden
+template<typename T, bool destruct = true, u32 Alignment = alignof(T), typename Allocator = HeapAllocator>
 class Vector {
+    static_assert(Alignment && !(Alignment & (Alignment - 1)), "Vector alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "Vector alignment must be at least alignof(T)");
+
 public:
     using ValueType = T;
 
@@ -404,18 +1192,34 @@ public:
         Other.m_Capacity = 0;
     }
 
-    ~Vector() {
+    Vector& operator=(Vector&& Other) noexcept {
+        if (this == &Other) return *this;
         Clear();
 
         if (m_Data)
-            MemFree(m_Data);
-    }
-
-    void Reserve(u32 NewCapacity) {
-        if (NewCapacity <= m_Capacity)
-            return;
+            FreeStorage(m_Data);
 
-        T* NewData = (T*)MemAlloc(NewCapacity * sizeof(T));
+        m_Data = Other.m_Data;
+        m_Size = Other.m_Size;
+        m_Capacity = Other.m_Capacity;
+        Other.m_Data = nullptr;
+        Other.m_Size = 0;
+        Other.m_Capacity = 0;
+        return *this;
+    }
+
+    ~Vector() {
+        Clear();
+
+        if (m_Data)
+            FreeStorage(m_Data);
+    }
+
+    void Reserve(u32 NewCapacity) {
+        if (NewCapacity <= m_Capacity)
+            return;
+
+        T* NewData = AllocStorage(NewCapacity);
         if (!NewData)
             return;
 
@@ -428,7 +1232,7 @@ public:
         }
 
         if (m_Data)
-            MemFree(m_Data);
+            FreeStorage(m_Data);
 
         m_Data = NewData;
         m_Capacity = NewCapacity;
@@ -589,107 +1393,1544 @@ private:
         Cap |= Cap >> 16;
         return Cap + 1;
     }
+
+    static T* AllocStorage(u32 Capacity) {
+        return (T*)Allocator::template Allocate<Alignment>((size_t)Capacity * sizeof(T));
+    }
+
+    static void FreeStorage(T* Data) {
+        Allocator::template Free<Alignment>(Data);
+    }
 };
 
+//Vector whose storage lives in the calling thread's scratch memory.
+//Must not outlive the ScratchScope it was created in.
 template<typename T>
-class FreeList {
+using ScratchVector = Vector<T, true, alignof(T), ScratchAllocator>;
+
+//Stores up to N elements inline and only moves to the heap beyond that.
+//Data is addressed relative to this, so a bitwise copy of an inline vector stays valid.
+template<typename T, u32 N, bool destruct = true>
+class InlineVector {
+    static_assert(N > 0, "InlineVector needs at least one inline element");
+
 public:
-    static_assert(sizeof(T) >= sizeof(size_t),
-        "FreeList<T> requires sizeof(T) >= sizeof(size_t)");
+    using ValueType = T;
 
-    FreeList()
-        : m_FreeHead(Npos) {
+    InlineVector() : m_Heap(nullptr), m_Size(0), m_Capacity(N) {}
+
+    InlineVector(u32 Size)
+        : m_Heap(nullptr), m_Size(0), m_Capacity(N) {
+        Resize(Size);
     }
 
-    size_t Allocate() {
-        if (m_FreeHead != Npos) {
-            const size_t Index{ m_FreeHead };
-            m_FreeHead = ReadNext(Index);
-            return Index;
-        }
+    InlineVector(u32 Size, const T& Value)
+        : m_Heap(nullptr), m_Size(0), m_Capacity(N) {
+        Reserve(Size);
+
+        for (u32 i = 0; i < Size; ++i)
+            new (&Ptr()[i]) T(Value);
+
+        m_Size = Size;
+    }
 
-        const size_t Index{ m_Data.Size() };
-        m_Data.Resize((u32)(Index + 1));
-        return Index;
+    template<typename It>
+    InlineVector(It First, It Last)
+        : m_Heap(nullptr), m_Size(0), m_Capacity(N) {
+        Reserve(static_cast<u32>(Last - First));
+
+        for (It Itor = First; Itor != Last; ++Itor)
+            new (&Ptr()[m_Size++]) T(*Itor);
+    }
+
+    InlineVector(const InlineVector& Other)
+        : m_Heap(nullptr), m_Size(0), m_Capacity(N) {
+        CopyFrom(Other);
     }
 
-    void Free(size_t Index) {
-        WriteNext(Index, m_FreeHead);
-        m_FreeHead = Index;
+    InlineVector(InlineVector&& Other) noexcept
+        : m_Heap(nullptr), m_Size(0), m_Capacity(N) {
+        MoveFrom(Other);
     }
 
-    T& operator[](size_t Index) {
-        return m_Data[(u32)Index];
+    InlineVector& operator=(const InlineVector& Other) {
+        if (this == &Other) return *this;
+        Clear();
+        CopyFrom(Other);
+        return *this;
     }
 
-    const T& operator[](size_t Index) const {
-        return m_Data[(u32)Index];
+    InlineVector& operator=(InlineVector&& Other) noexcept {
+        if (this == &Other) return *this;
+        Release();
+        MoveFrom(Other);
+        return *this;
     }
 
-    T* Data() {
-        return m_Data.Data();
+    ~InlineVector() {
+        Release();
     }
 
-    const T* Data() const {
-        return m_Data.Data();
+    void Reserve(u32 NewCapacity) {
+        if (NewCapacity <= m_Capacity)
+            return;
+
+        T* NewData = (T*)HeapAllocator::Allocate<alignof(T)>((size_t)NewCapacity * sizeof(T));
+        if (!NewData)
+            return;
+
+        T* OldData = Ptr();
+        for (u32 i = 0; i < m_Size; ++i)
+            new (&NewData[i]) T(Move(OldData[i]));
+
+        if constexpr (destruct) {
+            for (u32 i = 0; i < m_Size; ++i)
+                OldData[i].~T();
+        }
+
+        if (m_Heap)
+            HeapAllocator::Free<alignof(T)>(m_Heap);
+
+        m_Heap = NewData;
+        m_Capacity = NewCapacity;
     }
 
-    constexpr size_t Size() const {
-        return m_Data.Size();
+    void Resize(u32 NewSize) {
+        if (NewSize > m_Capacity)
+            Reserve(GrowCapacity(NewSize));
+
+        T* Data = Ptr();
+        if (NewSize > m_Size) {
+            for (u32 i = m_Size; i < NewSize; ++i)
+                new (&Data[i]) T();
+        }
+        else if (NewSize < m_Size) {
+            if constexpr (destruct) {
+                for (u32 i = NewSize; i < m_Size; ++i)
+                    Data[i].~T();
+            }
+        }
+
+        m_Size = NewSize;
     }
 
     void Clear() {
-        m_Data.Clear();
-        m_FreeHead = Npos;
+        if constexpr (destruct) {
+            T* Data = Ptr();
+            for (u32 i = 0; i < m_Size; ++i)
+                Data[i].~T();
+        }
+
+        m_Size = 0;
+    }
+
+    template<typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (m_Size >= m_Capacity)
+            Reserve(GrowCapacity(m_Size + 1));
+
+        T* Slot = &Ptr()[m_Size++];
+        new (Slot) T(static_cast<Args&&>(args)...);
+        return *Slot;
+    }
+
+    void PushBack(const T& Value) {
+        if (m_Size >= m_Capacity)
+            Reserve(GrowCapacity(m_Size + 1));
+
+        new (&Ptr()[m_Size]) T(Value);
+        ++m_Size;
+    }
+
+    void PushBack(T&& Value) {
+        if (m_Size >= m_Capacity)
+            Reserve(GrowCapacity(m_Size + 1));
+
+        new (&Ptr()[m_Size]) T(static_cast<T&&>(Value));
+        ++m_Size;
+    }
+
+    void PopBack() {
+        if (m_Size == 0)
+            return;
+
+        --m_Size;
+
+        if constexpr (destruct)
+            Ptr()[m_Size].~T();
+    }
+
+    void Erase(u32 Index) {
+        Erase(Index, Index + 1);
+    }
+
+    void Erase(u32 FirstIndex, u32 LastIndex) {
+        if (FirstIndex >= m_Size || LastIndex > m_Size || FirstIndex >= LastIndex)
+            return;
+
+        T* Data = Ptr();
+        u32 Count = LastIndex - FirstIndex;
+
+        if constexpr (destruct) {
+            for (u32 i = FirstIndex; i < LastIndex; ++i)
+                Data[i].~T();
+        }
+
+        for (u32 i = FirstIndex; i + Count < m_Size; ++i) {
+            new (&Data[i]) T(Move(Data[i + Count]));
+
+            if constexpr (destruct)
+                Data[i + Count].~T();
+        }
+
+        m_Size -= Count;
+    }
+
+    T* Erase(T* Pos) {
+        if (Pos < begin() || Pos >= end())
+            return end();
+
+        u32 Index = static_cast<u32>(Pos - begin());
+        Erase(Index);
+
+        return begin() + Index;
     }
 
-    bool Valid(size_t Index) const {
-        return Index < m_Data.Size();
+    T* Erase(T* First, T* Last) {
+        if (First < begin() || Last > end() || First >= Last)
+            return end();
+
+        u32 FirstIndex = static_cast<u32>(First - begin());
+        u32 LastIndex = static_cast<u32>(Last - begin());
+
+        Erase(FirstIndex, LastIndex);
+
+        return begin() + FirstIndex;
     }
 
-    static constexpr size_t Npos = (size_t)-1;
+    T& operator[](u32 Index) { return Ptr()[Index]; }
+    const T& operator[](u32 Index) const { return Ptr()[Index]; }
+
+    T& Back() { return Ptr()[m_Size - 1]; }
+    const T& Back() const { return Ptr()[m_Size - 1]; }
+
+    inline T* Data() { return Ptr(); }
+    inline const T* Data() const { return Ptr(); }
+
+    inline T* begin() { return Ptr(); }
+    inline const T* begin() const { return Ptr(); }
+
+    inline T* end() { return Ptr() + m_Size; }
+    inline const T* end() const { return Ptr() + m_Size; }
+
+    constexpr u32 Size() const { return m_Size; }
+    constexpr u32 Capacity() const { return m_Capacity; }
+    constexpr bool Empty() const { return m_Size == 0; }
+    constexpr bool IsInline() const { return m_Heap == nullptr; }
 
 private:
-    Vector<T> m_Data;
-    size_t    m_FreeHead;
+    alignas(T) u8   m_Inline[N * sizeof(T)];
+    T*              m_Heap;
+    u32             m_Size;
+    u32             m_Capacity;
+
+    inline T* Ptr() { return m_Heap ? m_Heap : (T*)m_Inline; }
+    inline const T* Ptr() const { return m_Heap ? m_Heap : (const T*)m_Inline; }
+
+    void CopyFrom(const InlineVector& Other) {
+        Reserve(Other.m_Size);
+
+        T* Data = Ptr();
+        const T* OtherData = Other.Ptr();
+        for (u32 i = 0; i < Other.m_Size; ++i)
+            new (&Data[i]) T(OtherData[i]);
+
+        m_Size = Other.m_Size;
+    }
+
+    void MoveFrom(InlineVector& Other) {
+        if (Other.m_Heap) {
+            m_Heap = Other.m_Heap;
+            m_Size = Other.m_Size;
+            m_Capacity = Other.m_Capacity;
+        }
+        else {
+            T* OtherData = Other.Ptr();
+            for (u32 i = 0; i < Other.m_Size; ++i) {
+                new (&Ptr()[i]) T(Move(OtherData[i]));
+
+                if constexpr (destruct)
+                    OtherData[i].~T();
+            }
+
+            m_Size = Other.m_Size;
+        }
+
+        Other.m_Heap = nullptr;
+        Other.m_Size = 0;
+        Other.m_Capacity = N;
+    }
+
+    void Release() {
+        Clear();
 
-    inline size_t ReadNext(size_t Index) const {
-        return *(const size_t*)(&m_Data[(u32)Index]);
+        if (m_Heap)
+            HeapAllocator::Free<alignof(T)>(m_Heap);
+
+        m_Heap = nullptr;
+        m_Capacity = N;
     }
 
-    inline void WriteNext(size_t Index, size_t Next) {
-        *(size_t*)(&m_Data[(u32)Index]) = Next;
+    static u32 GrowCapacity(u32 MinCapacity) {
+        u32 Cap = MinCapacity > 1 ? MinCapacity : 1;
+        Cap |= Cap >> 1;
+        Cap |= Cap >> 2;
+        Cap |= Cap >> 4;
+        Cap |= Cap >> 8;
+        Cap |= Cap >> 16;
+        return Cap + 1;
     }
 };
 
-class ConfigFile {
+//Reserves address space for MaxCapacity elements up front and commits pages as it grows.
+//Elements are never moved, pointers stay valid until the element is removed.
+template<typename T, bool destruct = true>
+class VirtualVector {
 public:
-    ConfigFile() = default;
-    CORE_API ~ConfigFile();
+    using ValueType = T;
 
-    CORE_API Result::Code Load(const char* File);
-    CORE_API Result::Code Save(const char* Path) const;
+    constexpr static u32 DefaultMaxCapacity{ 1u << 20 };
+    constexpr static u64 CommitGranularity{ 64 * 1024 };
 
-    CORE_API void Set(
-        const char* Section,
-        const char* Keyword,
-        const char* Value);
+    explicit VirtualVector(u32 MaxCapacity = DefaultMaxCapacity)
+        : m_Data(nullptr), m_Size(0), m_Capacity(0), m_MaxCapacity(MaxCapacity) {}
 
-    CORE_API const char* Get(
-        const char* Section,
-        const char* Keyword,
-        const char* DefaultValue = nullptr) const;
+    VirtualVector(const VirtualVector&) = delete;
+    VirtualVector& operator=(const VirtualVector&) = delete;
 
-    CORE_API void Clear();
+    VirtualVector(VirtualVector&& Other) noexcept
+        : m_Data(Other.m_Data),
+        m_Size(Other.m_Size),
+        m_Capacity(Other.m_Capacity),
+        m_MaxCapacity(Other.m_MaxCapacity) {
+        Other.m_Data = nullptr;
+        Other.m_Size = 0;
+        Other.m_Capacity = 0;
+    }
 
-private:
-    struct Entry {
-        const char* Section;
-        const char* Keyword;
-        const char* Value;
+    VirtualVector& operator=(VirtualVector&& Other) noexcept {
+        if (this == &Other) return *this;
+        Release();
+        m_Data = Other.m_Data;
+        m_Size = Other.m_Size;
+        m_Capacity = Other.m_Capacity;
+        m_MaxCapacity = Other.m_MaxCapacity;
+        Other.m_Data = nullptr;
+        Other.m_Size = 0;
+        Other.m_Capacity = 0;
+        return *this;
+    }
+
+    ~VirtualVector() {
+        Release();
+    }
+
+    bool Reserve(u32 NewCapacity) {
+        if (NewCapacity <= m_Capacity)
+            return true;
+
+        if (NewCapacity > m_MaxCapacity) UNLIKELY {
+            LOG_FATAL("VirtualVector exceeded its maximum capacity of %u elements!", m_MaxCapacity);
+            return false;
+        }
+
+        if (!m_Data) {
+            m_Data = (T*)VirtualReserve(ReservedBytes());
+            if (!m_Data)
+                return false;
+        }
+
+        const u64 Committed{ CommittedBytes(m_Capacity) };
+        const u64 NewCommitted{ CommittedBytes(NewCapacity) };
+        if (!VirtualCommit((u8*)m_Data + Committed, NewCommitted - Committed))
+            return false;
+
+        const u64 Fits{ NewCommitted / sizeof(T) };
+        m_Capacity = Fits < m_MaxCapacity ? (u32)Fits : m_MaxCapacity;
+        return true;
+    }
+
+    //Returns the pages past the last element to the OS, the address range stays reserved
+    void ShrinkToFit() {
+        if (!m_Data)
+            return;
+
+        const u64 Committed{ CommittedBytes(m_Capacity) };
+        const u64 Needed{ CommittedBytes(m_Size) };
+        if (Needed < Committed) {
+            VirtualDecommit((u8*)m_Data + Needed, Committed - Needed);
+            m_Capacity = (u32)(Needed / sizeof(T));
+        }
+    }
+
+    void Resize(u32 NewSize) {
+        if (NewSize > m_Capacity && !Reserve(NewSize))
+            return;
+
+        if (NewSize > m_Size) {
+            for (u32 i = m_Size; i < NewSize; ++i)
+                new (&m_Data[i]) T();
+        }
+        else if (NewSize < m_Size) {
+            if constexpr (destruct) {
+                for (u32 i = NewSize; i < m_Size; ++i)
+                    m_Data[i].~T();
+            }
+        }
+
+        m_Size = NewSize;
+    }
+
+    void Clear() {
+        if constexpr (destruct) {
+            for (u32 i = 0; i < m_Size; ++i)
+                m_Data[i].~T();
+        }
+
+        m_Size = 0;
+    }
+
+    //Returns nullptr once the reserved range is exhausted
+    template<typename... Args>
+    T* EmplaceBack(Args&&... args) {
+        if (m_Size >= m_Capacity && !Reserve(m_Size + 1))
+            return nullptr;
+
+        new (&m_Data[m_Size]) T(static_cast<Args&&>(args)...);
+        return &m_Data[m_Size++];
+    }
+
+    void PushBack(const T& Value) {
+        if (m_Size >= m_Capacity && !Reserve(m_Size + 1))
+            return;
+
+        new (&m_Data[m_Size]) T(Value);
+        ++m_Size;
+    }
+
+    void PushBack(T&& Value) {
+        if (m_Size >= m_Capacity && !Reserve(m_Size + 1))
+            return;
+
+        new (&m_Data[m_Size]) T(static_cast<T&&>(Value));
+        ++m_Size;
+    }
+
+    void PopBack() {
+        if (m_Size == 0)
+            return;
+
+        --m_Size;
+
+        if constexpr (destruct)
+            m_Data[m_Size].~T();
+    }
+
+    T& operator[](u32 Index) { return m_Data[Index]; }
+    const T& operator[](u32 Index) const { return m_Data[Index]; }
+
+    T& Back() { return m_Data[m_Size - 1]; }
+    const T& Back() const { return m_Data[m_Size - 1]; }
+
+    inline T* Data() { return m_Data; }
+    inline const T* Data() const { return m_Data; }
+
+    inline T* begin() { return m_Data; }
+    inline const T* begin() const { return m_Data; }
+
+    inline T* end() { return m_Data + m_Size; }
+    inline const T* end() const { return m_Data + m_Size; }
+
+    constexpr u32 Size() const { return m_Size; }
+    constexpr u32 Capacity() const { return m_Capacity; }
+    constexpr u32 MaxCapacity() const { return m_MaxCapacity; }
+    constexpr bool Empty() const { return m_Size == 0; }
+
+private:
+    T*      m_Data;
+    u32     m_Size;
+    u32     m_Capacity;
+    u32     m_MaxCapacity;
+
+    constexpr static u64 AlignToGranularity(u64 Size) {
+        return (Size + (CommitGranularity - 1)) & ~(CommitGranularity - 1);
+    }
+
+    u64 ReservedBytes() const {
+        return AlignToGranularity((u64)m_MaxCapacity * sizeof(T));
+    }
+
+    u64 CommittedBytes(u32 Count) const {
+        return AlignToGranularity((u64)Count * sizeof(T));
+    }
+
+    void Release() {
+        Clear();
+
+        if (m_Data)
+            VirtualRelease(m_Data, ReservedBytes());
+
+        m_Data = nullptr;
+        m_Capacity = 0;
+    }
+};
+
+//Default hash for integers, enums and pointers, other keys need their own hasher.
+//The table mixes the result, so identity is fine here.
+template<typename K>
+struct Hasher {
+    constexpr u64 operator()(const K& Key) const noexcept { return (u64)Key; }
+};
+
+//Transparent, so lookups can use any type comparable with the key
+struct EqualTo {
+    template<typename A, typename B>
+    constexpr bool operator()(const A& Lhs, const B& Rhs) const noexcept { return Lhs == Rhs; }
+};
+
+//Open addressing map with Robin Hood probing and backward shift deletion.
+//Entries live in one flat block of Allocator, pointers to them are invalidated by insert and erase.
+template<typename K, typename V, typename Hash = Hasher<K>, typename Eq = EqualTo, typename Allocator = HeapAllocator>
+class HashMap {
+public:
+    struct Pair {
+        K       Key;
+        V       Value;
+    };
+
+    template<typename P>
+    class Iter {
+    public:
+        Iter(const u16* Dist, P* Slots, u32 Index, u32 Capacity)
+            : m_Dist(Dist), m_Slots(Slots), m_Index(Index), m_Capacity(Capacity) {
+            Skip();
+        }
+
+        P& operator*() const { return m_Slots[m_Index]; }
+        P* operator->() const { return &m_Slots[m_Index]; }
+
+        Iter& operator++() {
+            ++m_Index;
+            Skip();
+            return *this;
+        }
+
+        bool operator!=(const Iter& Other) const { return m_Index != Other.m_Index; }
+        bool operator==(const Iter& Other) const { return m_Index == Other.m_Index; }
+
+    private:
+        const u16*  m_Dist;
+        P*          m_Slots;
+        u32         m_Index;
+        u32         m_Capacity;
+
+        void Skip() {
+            while (m_Index < m_Capacity && !m_Dist[m_Index])
+                ++m_Index;
+        }
+    };
+
+    using Iterator = Iter<Pair>;
+    using ConstIterator = Iter<const Pair>;
+
+    constexpr static u32 MinCapacity{ 8 };
+
+    HashMap() : m_Dist(nullptr), m_Slots(nullptr), m_Size(0), m_Capacity(0), m_Shift(64) {}
+
+    HashMap(const HashMap& Other)
+        : m_Dist(nullptr), m_Slots(nullptr), m_Size(0), m_Capacity(0), m_Shift(64) {
+        Reserve(Other.m_Size);
+        for (const Pair& P : Other)
+            Emplace(P.Key, P.Value);
+    }
+
+    HashMap(HashMap&& Other) noexcept
+        : m_Dist(Other.m_Dist),
+        m_Slots(Other.m_Slots),
+        m_Size(Other.m_Size),
+        m_Capacity(Other.m_Capacity),
+        m_Shift(Other.m_Shift) {
+        Other.m_Dist = nullptr;
+        Other.m_Slots = nullptr;
+        Other.m_Size = 0;
+        Other.m_Capacity = 0;
+        Other.m_Shift = 64;
+    }
+
+    HashMap& operator=(const HashMap& Other) {
+        if (this == &Other) return *this;
+        Clear();
+        Reserve(Other.m_Size);
+        for (const Pair& P : Other)
+            Emplace(P.Key, P.Value);
+        return *this;
+    }
+
+    HashMap& operator=(HashMap&& Other) noexcept {
+        if (this == &Other) return *this;
+        Release();
+        m_Dist = Other.m_Dist;
+        m_Slots = Other.m_Slots;
+        m_Size = Other.m_Size;
+        m_Capacity = Other.m_Capacity;
+        m_Shift = Other.m_Shift;
+        Other.m_Dist = nullptr;
+        Other.m_Slots = nullptr;
+        Other.m_Size = 0;
+        Other.m_Capacity = 0;
+        Other.m_Shift = 64;
+        return *this;
+    }
+
+    ~HashMap() {
+        Release();
+    }
+
+    //Makes room for Count entries without rehashing
+    void Reserve(u32 Count) {
+        u32 Needed = MinCapacity;
+        while ((u64)Needed * MaxLoadNum < (u64)Count * MaxLoadDen)
+            Needed <<= 1;
+
+        if (Needed > m_Capacity)
+            Rehash(Needed);
+    }
+
+    template<typename Q>
+    V* Find(const Q& Key) {
+        const u32 Index = FindIndex(Key);
+        return Index != max_u32 ? &m_Slots[Index].Value : nullptr;
+    }
+
+    template<typename Q>
+    const V* Find(const Q& Key) const {
+        const u32 Index = FindIndex(Key);
+        return Index != max_u32 ? &m_Slots[Index].Value : nullptr;
+    }
+
+    template<typename Q>
+    bool Contains(const Q& Key) const {
+        return FindIndex(Key) != max_u32;
+    }
+
+    //Inserts or assigns, nullptr when the map could not grow
+    template<typename... Args>
+    V* Emplace(const K& Key, Args&&... args) {
+        const u32 Index = FindIndex(Key);
+        if (Index != max_u32) {
+            m_Slots[Index].Value = V(static_cast<Args&&>(args)...);
+            return &m_Slots[Index].Value;
+        }
+
+        //Insert may rehash, so m_Slots must be read after it
+        const u32 Landed = Insert(Key, V(static_cast<Args&&>(args)...));
+        if (Landed == max_u32) UNLIKELY
+            return nullptr;
+
+        return &m_Slots[Landed].Value;
+    }
+
+    V& operator[](const K& Key) {
+        const u32 Index = FindIndex(Key);
+        if (Index != max_u32)
+            return m_Slots[Index].Value;
+
+        const u32 Landed = Insert(Key, V());
+        if (Landed == max_u32) UNLIKELY {
+            LOG_FATAL("HashMap failed to insert a new entry, %u entries!", m_Size);
+            std::terminate();
+        }
+
+        return m_Slots[Landed].Value;
+    }
+
+    template<typename Q>
+    bool Erase(const Q& Key) {
+        const u32 Index = FindIndex(Key);
+        if (Index == max_u32)
+            return false;
+
+        EraseAt(Index);
+        return true;
+    }
+
+    //Erases every entry the predicate returns true for, returns the erased count
+    template<typename F>
+    u32 EraseIf(F Pred) {
+        u32 Erased = 0;
+        for (u32 i = 0; i < m_Capacity; ) {
+            if (m_Dist[i] && Pred(m_Slots[i])) {
+                //Backward shift may pull the next entry into this slot, check it again
+                EraseAt(i);
+                ++Erased;
+            }
+            else {
+                ++i;
+            }
+        }
+
+        return Erased;
+    }
+
+    void Clear() {
+        for (u32 i = 0; i < m_Capacity; ++i) {
+            if (m_Dist[i]) {
+                m_Slots[i].~Pair();
+                m_Dist[i] = 0;
+            }
+        }
+
+        m_Size = 0;
+    }
+
+    Iterator begin() { return Iterator(m_Dist, m_Slots, 0, m_Capacity); }
+    Iterator end() { return Iterator(m_Dist, m_Slots, m_Capacity, m_Capacity); }
+    ConstIterator begin() const { return ConstIterator(m_Dist, m_Slots, 0, m_Capacity); }
+    ConstIterator end() const { return ConstIterator(m_Dist, m_Slots, m_Capacity, m_Capacity); }
+
+    constexpr u32 Size() const { return m_Size; }
+    constexpr u32 Capacity() const { return m_Capacity; }
+    constexpr bool Empty() const { return m_Size == 0; }
+
+private:
+    //Grow past 7/8 load, Robin Hood keeps probe lengths short up to there
+    constexpr static u32 MaxLoadNum{ 7 };
+    constexpr static u32 MaxLoadDen{ 8 };
+
+    u16*    m_Dist;     //Probe distance + 1, 0 marks an empty slot
+    Pair*   m_Slots;
+    u32     m_Size;
+    u32     m_Capacity;
+    u32     m_Shift;
+
+    template<typename Q>
+    u32 HomeIndex(const Q& Key) const {
+        //Fibonacci hashing spreads weak hashes over the top bits
+        return (u32)(((u64)Hash{}(Key) * 0x9e3779b97f4a7c15ull) >> m_Shift);
+    }
+
+    template<typename Q>
+    u32 FindIndex(const Q& Key) const {
+        if (!m_Size)
+            return max_u32;
+
+        const u32 Mask = m_Capacity - 1;
+        u32 Index = HomeIndex(Key);
+
+        for (u32 Dist = 1; Dist <= m_Dist[Index]; ++Dist) {
+            if (m_Dist[Index] == Dist && Eq{}(m_Slots[Index].Key, Key))
+                return Index;
+
+            Index = (Index + 1) & Mask;
+        }
+
+        return max_u32;
+    }
+
+    //Key must not be present, returns the slot the new entry landed in
+    u32 Insert(const K& Key, V&& Value) {
+        if (!m_Capacity || (u64)(m_Size + 1) * MaxLoadDen > (u64)m_Capacity * MaxLoadNum) {
+            if (!Grow())
+                return max_u32;
+        }
+
+        Pair Carry{ Key, static_cast<V&&>(Value) };
+        u32 Landed = max_u32;
+
+        if (Place(Carry, Landed))
+            return Landed;
+
+        //Probe sequence too long, grow until the displaced entry fits
+        do {
+            if (!Grow())
+                return max_u32;
+        } while (!Place(Carry, Landed));
+
+        return FindIndex(Key);
+    }
+
+    bool Grow() {
+        if (!Rehash(m_Capacity ? m_Capacity * 2 : MinCapacity)) UNLIKELY {
+            LOG_FATAL("HashMap failed to grow past %u entries!", m_Size);
+            return false;
+        }
+
+        return true;
+    }
+
+    //Robin Hood placement, Carry ends up holding whichever entry is still unplaced on failure
+    bool Place(Pair& Carry, u32& Landed) {
+        const u32 Mask = m_Capacity - 1;
+        u32 Index = HomeIndex(Carry.Key);
+
+        for (u32 Dist = 1; Dist < max_u16; ++Dist) {
+            if (!m_Dist[Index]) {
+                new (&m_Slots[Index]) Pair(Move(Carry));
+                m_Dist[Index] = (u16)Dist;
+                ++m_Size;
+
+                if (Landed == max_u32)
+                    Landed = Index;
+                return true;
+            }
+
+            if (m_Dist[Index] < Dist) {
+                //Take from the rich, the displaced entry continues probing
+                Pair Tmp{ Move(m_Slots[Index]) };
+                m_Slots[Index] = Move(Carry);
+                Carry = Move(Tmp);
+
+                const u32 Swapped = m_Dist[Index];
+                m_Dist[Index] = (u16)Dist;
+                Dist = Swapped;
+
+                if (Landed == max_u32)
+                    Landed = Index;
+            }
+
+            Index = (Index + 1) & Mask;
+        }
+
+        return false;
+    }
+
+    void EraseAt(u32 Index) {
+        const u32 Mask = m_Capacity - 1;
+
+        m_Slots[Index].~Pair();
+
+        u32 Next = (Index + 1) & Mask;
+        while (m_Dist[Next] > 1) {
+            new (&m_Slots[Index]) Pair(Move(m_Slots[Next]));
+            m_Slots[Next].~Pair();
+            m_Dist[Index] = m_Dist[Next] - 1;
+
+            Index = Next;
+            Next = (Next + 1) & Mask;
+        }
+
+        m_Dist[Index] = 0;
+        --m_Size;
+    }
+
+    bool Rehash(u32 NewCapacity) {
+        u16* OldDist = m_Dist;
+        Pair* OldSlots = m_Slots;
+        const u32 OldCapacity = m_Capacity;
+
+        //Slots first so they keep the block alignment, distances after them
+        const size_t SlotBytes = (size_t)NewCapacity * sizeof(Pair);
+        u8* Block = (u8*)Allocator::template Allocate<alignof(Pair)>(SlotBytes + NewCapacity * sizeof(u16));
+        if (!Block)
+            return false;
+
+        m_Slots = (Pair*)Block;
+        m_Dist = (u16*)(Block + SlotBytes);
+        MemSet(m_Dist, 0, NewCapacity * sizeof(u16));
+
+        m_Capacity = NewCapacity;
+        m_Size = 0;
+
+        u32 Log2 = 0;
+        while ((1u << Log2) < NewCapacity)
+            ++Log2;
+        m_Shift = 64 - Log2;
+
+        for (u32 i = 0; i < OldCapacity; ++i) {
+            if (OldDist[i]) {
+                Insert(OldSlots[i].Key, Move(OldSlots[i].Value));
+                OldSlots[i].~Pair();
+            }
+        }
+
+        if (OldSlots)
+            Allocator::template Free<alignof(Pair)>(OldSlots);
+
+        return true;
+    }
+
+    void Release() {
+        if (m_Slots) {
+            Clear();
+            Allocator::template Free<alignof(Pair)>(m_Slots);
+        }
+
+        m_Dist = nullptr;
+        m_Slots = nullptr;
+        m_Capacity = 0;
+        m_Shift = 64;
+    }
+};
+
+//Set counterpart of HashMap, same probing and invalidation rules
+template<typename K, typename Hash = Hasher<K>, typename Eq = EqualTo>
+class HashSet {
+    struct NoValue {};
+    using Map = HashMap<K, NoValue, Hash, Eq>;
+
+public:
+    class ConstIterator {
+    public:
+        ConstIterator(typename Map::ConstIterator It) : m_It(It) {}
+
+        const K& operator*() const { return m_It->Key; }
+        const K* operator->() const { return &m_It->Key; }
+
+        ConstIterator& operator++() {
+            ++m_It;
+            return *this;
+        }
+
+        bool operator!=(const ConstIterator& Other) const { return m_It != Other.m_It; }
+        bool operator==(const ConstIterator& Other) const { return m_It == Other.m_It; }
+
+    private:
+        typename Map::ConstIterator m_It;
+    };
+
+    void Reserve(u32 Count) { m_Map.Reserve(Count); }
+
+    //Returns false if the key was already present
+    bool Insert(const K& Key) {
+        if (m_Map.Contains(Key))
+            return false;
+
+        m_Map.Emplace(Key);
+        return true;
+    }
+
+    template<typename Q>
+    bool Contains(const Q& Key) const { return m_Map.Contains(Key); }
+
+    template<typename Q>
+    bool Erase(const Q& Key) { return m_Map.Erase(Key); }
+
+    template<typename F>
+    u32 EraseIf(F Pred) {
+        return m_Map.EraseIf([&](const typename Map::Pair& P) { return Pred(P.Key); });
+    }
+
+    void Clear() { m_Map.Clear(); }
+
+    ConstIterator begin() const { return ConstIterator(m_Map.begin()); }
+    ConstIterator end() const { return ConstIterator(m_Map.end()); }
+
+    constexpr u32 Size() const { return m_Map.Size(); }
+    constexpr u32 Capacity() const { return m_Map.Capacity(); }
+    constexpr bool Empty() const { return m_Map.Empty(); }
+
+private:
+    Map     m_Map;
+};
+
+//SlotMap storage policies. Grow makes room for Count elements, false if it could not.
+struct HeapStorage {
+    template<typename U>
+    using Type = Vector<U>;
+
+    //Vector::Reserve only reports failure through the capacity
+    template<typename U>
+    static bool Grow(Vector<U>& Values, u32 Count) {
+        if (Count > Values.Capacity())
+            Values.Reserve(Count > Values.Capacity() * 2 ? Count : Values.Capacity() * 2);
+
+        return Count <= Values.Capacity();
+    }
+};
+
+struct VirtualStorage {
+    template<typename U>
+    using Type = VirtualVector<U>;
+
+    template<typename U>
+    static bool Grow(VirtualVector<U>& Values, u32 Count) {
+        return Values.Reserve(Count);
+    }
+};
+
+//Generational handle map. Values are kept packed for iteration, erase moves the last
+//value into the hole, so pointers and dense indices are invalidated by erase.
+//Handles are Id:: handles, a stale handle never resolves once its slot is reused.
+template<typename T, typename Storage = HeapStorage>
+class SlotMap {
+public:
+    using ValueType = T;
+
+    SlotMap() = default;
+
+    SlotMap(const SlotMap&) = delete;
+    SlotMap& operator=(const SlotMap&) = delete;
+
+    void Reserve(u32 Capacity) {
+        m_Values.Reserve(Capacity);
+        m_DenseToSlot.Reserve(Capacity);
+        m_Slots.Reserve(Capacity);
+    }
+
+    TypeId Insert(const T& Value) {
+        return Emplace(Value);
+    }
+
+    TypeId Insert(T&& Value) {
+        return Emplace(static_cast<T&&>(Value));
+    }
+
+    //Returns Id::InvalidId if the storage is exhausted
+    template<typename... Args>
+    TypeId Emplace(Args&&... args) {
+        const u32 DenseIndex = m_Values.Size();
+        const bool NewSlot = m_FreeHead == max_u32;
+        if (NewSlot && m_Slots.Size() >= Id::IndexMask) UNLIKELY
+            return Id::InvalidId;
+
+        //Room is made in every array first, so a failure leaves them in sync
+        if (!Storage::Grow(m_Values, DenseIndex + 1) || !Storage::Grow(m_DenseToSlot, DenseIndex + 1)
+            || (NewSlot && !Storage::Grow(m_Slots, m_Slots.Size() + 1))) UNLIKELY
+            return Id::InvalidId;
+
+        m_Values.EmplaceBack(static_cast<Args&&>(args)...);
+
+        u32 SlotIndex = m_FreeHead;
+        if (!NewSlot) {
+            m_FreeHead = m_Slots[SlotIndex].DenseIndex;
+        }
+        else {
+            SlotIndex = m_Slots.Size();
+            m_Slots.PushBack({ Id::MakeHandle(SlotIndex, 0), 0 });
+        }
+
+        m_DenseToSlot.PushBack(SlotIndex);
+
+        Slot& S = m_Slots[SlotIndex];
+        S.DenseIndex = DenseIndex;
+        return S.Handle;
+    }
+
+    bool Erase(TypeId Handle) {
+        const u32 SlotIndex = Resolve(Handle);
+        if (SlotIndex == max_u32)
+            return false;
+
+        Slot& S = m_Slots[SlotIndex];
+        const u32 DenseIndex = S.DenseIndex;
+        const u32 LastIndex = m_Values.Size() - 1;
+
+        if (DenseIndex != LastIndex) {
+            m_Values[DenseIndex] = Move(m_Values[LastIndex]);
+            m_DenseToSlot[DenseIndex] = m_DenseToSlot[LastIndex];
+            m_Slots[m_DenseToSlot[DenseIndex]].DenseIndex = DenseIndex;
+        }
+
+        m_Values.PopBack();
+        m_DenseToSlot.PopBack();
+
+        //Bumping the generation is what invalidates outstanding handles
+        S.Handle = Id::NextGeneration(S.Handle);
+        S.DenseIndex = m_FreeHead;
+        m_FreeHead = SlotIndex;
+
+        return true;
+    }
+
+    T* Get(TypeId Handle) {
+        const u32 SlotIndex = Resolve(Handle);
+        if (SlotIndex == max_u32) {
+            WarnStale(Handle);
+            return nullptr;
+        }
+
+        return &m_Values[m_Slots[SlotIndex].DenseIndex];
+    }
+
+    const T* Get(TypeId Handle) const {
+        const u32 SlotIndex = Resolve(Handle);
+        if (SlotIndex == max_u32) {
+            WarnStale(Handle);
+            return nullptr;
+        }
+
+        return &m_Values[m_Slots[SlotIndex].DenseIndex];
+    }
+
+    //Silent, this is how callers ask whether a handle is still alive
+    bool Contains(TypeId Handle) const {
+        return Resolve(Handle) != max_u32;
+    }
+
+    //Handle of the value at a dense index, for iterating with handles
+    TypeId HandleAt(u32 DenseIndex) const {
+        return m_Slots[m_DenseToSlot[DenseIndex]].Handle;
+    }
+
+    //Invalidates every outstanding handle
+    void Clear() {
+        for (u32 i = 0; i < m_Values.Size(); ++i) {
+            Slot& S = m_Slots[m_DenseToSlot[i]];
+            S.Handle = Id::NextGeneration(S.Handle);
+            S.DenseIndex = m_FreeHead;
+            m_FreeHead = m_DenseToSlot[i];
+        }
+
+        m_Values.Clear();
+        m_DenseToSlot.Clear();
+    }
+
+    T& operator[](u32 DenseIndex) { return m_Values[DenseIndex]; }
+    const T& operator[](u32 DenseIndex) const { return m_Values[DenseIndex]; }
+
+    inline T* Data() { return m_Values.Data(); }
+    inline const T* Data() const { return m_Values.Data(); }
+
+    inline T* begin() { return m_Values.begin(); }
+    inline const T* begin() const { return m_Values.begin(); }
+
+    inline T* end() { return m_Values.end(); }
+    inline const T* end() const { return m_Values.end(); }
+
+    constexpr u32 Size() const { return m_Values.Size(); }
+    constexpr bool Empty() const { return m_Values.Empty(); }
+
+private:
+    struct Slot {
+        TypeId      Handle;
+        u32         DenseIndex;     //Next free slot while the slot is free
+    };
+
+    typename Storage::template Type<T>      m_Values{};
+    typename Storage::template Type<u32>    m_DenseToSlot{};
+    typename Storage::template Type<Slot>   m_Slots{};
+    u32                                     m_FreeHead{ max_u32 };
+
+    u32 Resolve(TypeId Handle) const {
+        if (!Id::IsValid(Handle))
+            return max_u32;
+
+        const u32 SlotIndex = Id::Index(Handle);
+        if (SlotIndex >= m_Slots.Size())
+            return max_u32;
+
+        if (m_Slots[SlotIndex].Handle != Handle)
+            return max_u32;
+
+        return SlotIndex;
+    }
+
+    void WarnStale(TypeId Handle) const {
+#ifdef _DEBUG
+        const u32 SlotIndex = Id::Index(Handle);
+        if (Id::IsValid(Handle) && SlotIndex < m_Slots.Size()) {
+            LOG_WARNING("Stale handle %u used, slot %u is at generation %u",
+                Handle, SlotIndex, Id::Generation(m_Slots[SlotIndex].Handle));
+        }
+#else
+        (void)Handle;
+#endif
+    }
+};
+
+//Object pool built from fixed size chunks. Chunks are never moved or freed while the
+//pool is alive, so pointers returned by Create() stay valid until Destroy().
+//Each slot has a live bit, ForEach() visits live objects only and skips empty words.
+template<typename T, u32 SlotsPerChunk = 64>
+class ChunkedPool {
+public:
+    static_assert(SlotsPerChunk && SlotsPerChunk % 64 == 0,
+        "ChunkedPool<T> requires SlotsPerChunk to be a multiple of 64");
+
+    ChunkedPool() = default;
+
+    ChunkedPool(const ChunkedPool&) = delete;
+    ChunkedPool& operator=(const ChunkedPool&) = delete;
+
+    ~ChunkedPool() {
+        Release();
+    }
+
+    //Returns nullptr if a new chunk could not be allocated
+    template<typename... Args>
+    T* Create(Args&&... args) {
+        if (!m_FreeHead && !AddChunk()) UNLIKELY {
+            return nullptr;
+        }
+
+        Slot* S{ m_FreeHead };
+        Chunk* C{ S->Free.Owner };
+        m_FreeHead = S->Free.Next;
+
+        const u32 Index{ (u32)(S - C->Slots) };
+        C->Live[Index >> 6] |= 1ull << (Index & 63);
+        ++m_Size;
+
+        return new (S->Storage) T(static_cast<Args&&>(args)...);
+    }
+
+    void Destroy(T* Object) {
+        Chunk* C{ Object ? FindChunk(Object) : nullptr };
+        if (!C) {
+            return;
+        }
+
+        Slot* S{ (Slot*)Object };
+        const u32 Index{ (u32)(S - C->Slots) };
+        const u64 Bit{ 1ull << (Index & 63) };
+
+        if (!(C->Live[Index >> 6] & Bit)) UNLIKELY {
+            LOG_WARNING("ChunkedPool: object %p destroyed twice", Object);
+            return;
+        }
+
+        Object->~T();
+        C->Live[Index >> 6] &= ~Bit;
+        --m_Size;
+
+        S->Free = { m_FreeHead, C };
+        m_FreeHead = S;
+    }
+
+    //True if Object points at a live object owned by this pool
+    bool IsLive(const T* Object) const {
+        const Chunk* C{ Object ? FindChunk(Object) : nullptr };
+        if (!C) {
+            return false;
+        }
+
+        const u32 Index{ (u32)((const Slot*)Object - C->Slots) };
+        return (C->Live[Index >> 6] >> (Index & 63)) & 1;
+    }
+
+    template<typename F>
+    void ForEach(F&& Func) {
+        for (Chunk* C : m_Chunks) {
+            for (u32 W{ 0 }; W < WordCount; ++W) {
+                u64 Bits{ C->Live[W] };
+                while (Bits) {
+                    const u32 Index{ (W << 6) | LowestBit(Bits) };
+                    Bits &= Bits - 1;
+                    Func(*(T*)C->Slots[Index].Storage);
+                }
+            }
+        }
+    }
+
+    template<typename F>
+    void ForEach(F&& Func) const {
+        for (const Chunk* C : m_Chunks) {
+            for (u32 W{ 0 }; W < WordCount; ++W) {
+                u64 Bits{ C->Live[W] };
+                while (Bits) {
+                    const u32 Index{ (W << 6) | LowestBit(Bits) };
+                    Bits &= Bits - 1;
+                    Func(*(const T*)C->Slots[Index].Storage);
+                }
+            }
+        }
+    }
+
+    //Destroys every live object, chunks are kept for reuse
+    void Clear() {
+        m_FreeHead = nullptr;
+
+        for (u32 I{ m_Chunks.Size() }; I-- > 0;) {
+            Chunk* C{ m_Chunks[I] };
+
+            for (u32 Index{ SlotsPerChunk }; Index-- > 0;) {
+                Slot& S{ C->Slots[Index] };
+                if (C->Live[Index >> 6] & (1ull << (Index & 63))) {
+                    ((T*)S.Storage)->~T();
+                }
+
+                S.Free = { m_FreeHead, C };
+                m_FreeHead = &S;
+            }
+
+            for (u32 W{ 0 }; W < WordCount; ++W) {
+                C->Live[W] = 0;
+            }
+        }
+
+        m_Size = 0;
+    }
+
+    //Destroys every live object and frees all chunks
+    void Release() {
+        Clear();
+
+        for (Chunk* C : m_Chunks) {
+            HeapAllocator::Free<alignof(Chunk)>(C);
+        }
+
+        m_Chunks.Clear();
+        m_FreeHead = nullptr;
+    }
+
+    constexpr u32 Size() const { return m_Size; }
+    constexpr u32 Capacity() const { return m_Chunks.Size() * SlotsPerChunk; }
+    constexpr bool Empty() const { return m_Size == 0; }
+
+private:
+    constexpr static u32 WordCount{ SlotsPerChunk / 64 };
+
+    struct Chunk;
+    union Slot;
+
+    //Free slots know their chunk, so Create() never searches for it
+    struct FreeSlot {
+        Slot*                   Next;
+        Chunk*                  Owner;
+    };
+
+    union Slot {
+        FreeSlot                Free;
+        alignas(T) u8           Storage[sizeof(T)];
+    };
+
+    struct Chunk {
+        u64                     Live[WordCount];
+        Slot                    Slots[SlotsPerChunk];
+    };
+
+    Vector<Chunk*, false>       m_Chunks{};     //Sorted by address
+    Slot*                       m_FreeHead{};
+    u32                         m_Size{};
+
+    bool AddChunk() {
+        Chunk* C{ (Chunk*)HeapAllocator::Allocate<alignof(Chunk)>(sizeof(Chunk)) };
+        if (!C) {
+            return false;
+        }
+
+        for (u32 W{ 0 }; W < WordCount; ++W) {
+            C->Live[W] = 0;
+        }
+
+        //Link in address order so new objects fill the chunk front to back
+        for (u32 Index{ SlotsPerChunk }; Index-- > 0;) {
+            C->Slots[Index].Free = { m_FreeHead, C };
+            m_FreeHead = &C->Slots[Index];
+        }
+
+        m_Chunks.PushBack(C);
+        for (u32 I{ m_Chunks.Size() - 1 }; I > 0 && m_Chunks[I - 1] > m_Chunks[I]; --I) {
+            Chunk* Tmp{ m_Chunks[I - 1] };
+            m_Chunks[I - 1] = m_Chunks[I];
+            m_Chunks[I] = Tmp;
+        }
+
+        return true;
+    }
+
+    //Binary search for the chunk whose slot range contains Address
+    Chunk* FindChunk(const void* Address) const {
+        const u8* A{ (const u8*)Address };
+        u32 Low{ 0 };
+        u32 High{ m_Chunks.Size() };
+
+        while (Low < High) {
+            const u32 Mid{ (Low + High) >> 1 };
+            Chunk* C{ m_Chunks[Mid] };
+
+            if (A < (const u8*)C->Slots) {
+                High = Mid;
+            }
+            else if (A >= (const u8*)(C->Slots + SlotsPerChunk)) {
+                Low = Mid + 1;
+            }
+            else {
+                return ((A - (const u8*)C->Slots) % sizeof(Slot)) ? nullptr : C;
+            }
+        }
+
+        return nullptr;
+    }
+
+    //Index of the lowest set bit, Bits must not be zero
+    static constexpr u32 LowestBit(u64 Bits) {
+        constexpr u8 Table[64]{
+             0,  1,  2, 53,  3,  7, 54, 27,  4, 38, 41,  8, 34, 55, 48, 28,
+            62,  5, 39, 46, 44, 42, 22,  9, 24, 35, 59, 56, 49, 18, 29, 11,
+            63, 52,  6, 26, 37, 40, 33, 47, 61, 45, 43, 21, 23, 58, 17, 10,
+            51, 25, 36, 32, 60, 20, 57, 16, 50, 31, 19, 15, 30, 14, 13, 12,
+        };
+
+        return Table[((Bits & (0 - Bits)) * 0x022FDD63CC95386Dull) >> 58];
+    }
+};
+
+struct FrameArenaStats {
+    u64         UsedBytes;      // Bytes handed out in the current frame
+    u64         CommittedBytes; // Bytes held by all frames, including overflow blocks
+    u64         HighWaterMark;  // Most bytes used by any single frame
+    u32         OverflowBlocks; // Overflow blocks chained since Initialize()
+};
+
+// N-buffered linear allocator, one buffer per frame in flight.
+// BeginFrame() resets the buffer that was last used FrameCount frames ago,
+// so memory stays valid until the frame that allocated it has retired.
+// Not thread safe, only use from the thread that calls BeginFrame().
+class FrameArena {
+public:
+    constexpr static u32 MaxFrames{ 4 };
+    constexpr static u64 DefaultAlignment{ 16 };
+
+    FrameArena() = default;
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+    CORE_API ~FrameArena();
+
+    CORE_API Result::Code Initialize(u32 FrameCount, u64 BlockSize);
+    CORE_API void Release();
+
+    CORE_API void BeginFrame(u64 FrameNumber);
+
+    CORE_API void* Allocate(u64 Size, u64 Alignment = DefaultAlignment);
+
+    template<typename T>
+    T* AllocateArray(u32 Count) {
+        return (T*)Allocate(sizeof(T) * (u64)Count, alignof(T) > DefaultAlignment
+            ? alignof(T) : DefaultAlignment);
+    }
+
+    CORE_API FrameArenaStats GetStats() const;
+
+    constexpr bool IsInitialized() const { return m_FrameCount != 0; }
+    constexpr u64 GetFrameNumber() const { return m_FrameNumber; }
+
+private:
+    struct Block {
+        Block*      Next;
+        u64         Size;
+        u64         Offset;
+    };
+
+    struct Frame {
+        Block*      Head;
+        Block*      Current;
+        u64         Used;
+    };
+
+    Block* AllocateBlock(u64 Size);
+    void ResetFrame(Frame& F);
+
+    Frame       m_Frames[MaxFrames]{};
+    u32         m_FrameCount{};
+    u32         m_Current{};
+    u64         m_FrameNumber{};
+    u64         m_BlockSize{};
+    u64         m_Committed{};
+    u64         m_HighWaterMark{};
+    u32         m_OverflowBlocks{};
+};
+
+/// Engine wide frame arena, reset by the engine at the start of each frame
+CORE_API FrameArena& GetFrameArena();
+
+inline void* FrameAlloc(u64 Size, u64 Alignment = FrameArena::DefaultAlignment) {
+    return GetFrameArena().Allocate(Size, Alignment);
+}
+
+using ConfigChangeCallback = void(*)(const char* Section, const char* Keyword, const char* Value, void* UserData);
+
+//Ini style config. Sections and keys are indexed by hash, all strings live in blocks owned
+//by the file and Save writes sections and keys back in the order they were loaded or added.
+class ConfigFile {
+public:
+    ConfigFile() = default;
+    ConfigFile(const ConfigFile&) = delete;
+    ConfigFile& operator=(const ConfigFile&) = delete;
+    CORE_API ~ConfigFile();
+
+    CORE_API Result::Code Load(const char* File);
+    CORE_API Result::Code Save(const char* Path) const;
+
+    CORE_API void Set(
+        const char* Section,
+        const char* Keyword,
+        const char* Value);
+
+    CORE_API const char* Get(
+        const char* Section,
+        const char* Keyword,
+        const char* DefaultValue = nullptr) const;
+
+    //Typed getters return the values parsed when the entry was loaded or Set, they only read
+    CORE_API s32 GetInt(const char* Section, const char* Keyword, s32 DefaultValue = 0) const;
+    CORE_API f32 GetFloat(const char* Section, const char* Keyword, f32 DefaultValue = 0.f) const;
+    CORE_API bool GetBool(const char* Section, const char* Keyword, bool DefaultValue = false) const;
+
+    //Takes every entry of Other that is new or differs and calls Callback for each of them.
+    //Keys missing from Other keep their value. Returns the number of changed entries.
+    CORE_API u32 Merge(const ConfigFile& Other, ConfigChangeCallback Callback = nullptr, void* UserData = nullptr);
+    //Parses File again and merges it, only the keys that changed reach Callback
+    CORE_API Result::Code Reload(const char* File, ConfigChangeCallback Callback = nullptr, void* UserData = nullptr);
+    //Writes the entries that differ from AsRead over a fresh copy of Path, so edits made to the
+    //file since it was read are kept. Saves everything when Path can't be read.
+    CORE_API Result::Code SaveChanges(const char* Path, const ConfigFile& AsRead) const;
+
+    CORE_API void Clear();
+
+private:
+    struct Entry {
+        const char*     Keyword;
+        const char*     Value;
+        u32             ValueCapacity;  //Bytes Value can hold in place, including the terminator
+        u32             Section;
+        u32             Next;           //Next entry of the section, max_u32 ends the list
+        u8              Valid;          //Valid* bits of the parsed values
+        bool            Bool;
+        s32             Int;
+        f32             Float;
+    };
+
+    struct SectionInfo {
+        const char*     Name;
+        u32             First;
+        u32             Last;
+    };
+
+    struct Key {
+        u64             Hash;
+        const char*     Name;
+        u32             Section;        //Owning section of a keyword, max_u32 for section names
+    };
+
+    struct KeyHash {
+        u64 operator()(const Key& K) const noexcept { return K.Hash; }
+    };
+
+    struct KeyEqual {
+        bool operator()(const Key& Lhs, const Key& Rhs) const noexcept;
+    };
+
+    struct Block {
+        Block*          Prev;
+        u64             Size;
     };
 
-    Vector<Entry> m_Entries{};
+    HashMap<Key, u32, KeyHash, KeyEqual>    m_Index{};
+    Vector<Entry>                           m_Entries{};
+    Vector<SectionInfo>                     m_Sections{};
+    Block*                                  m_Blocks{};
+    char*                                   m_Cursor{};
+    u64                                     m_Remaining{ 0 };
+
+    char* AllocString(u64 Size);
+    const char* CopyString(const char* Str);
+    u32 FindSection(const char* Name, u64 Hash) const;
+    u32 AddSection(const char* Name, u64 Hash);
+    const Entry* FindEntry(const char* Section, const char* Keyword) const;
+    static void ParseValue(Entry& E);
+    void SetInterned(u32 Section, const char* Keyword, const char* Value, u32 ValueCapacity);
+    void ParseBuffer(char* Buffer);
 };
 
 namespace Math {
@@ -0,0 +1,338 @@
+#pragma once
+#include <Iron.Core/Core.h>
+
+#include <bit>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+
+// Binary serialization on top of StreamWriter and StreamReader. Types list their fields:
+//
+//   struct MeshInfo {
+//       constexpr static u32 SerialMagic{ MakeFourCC('I', 'M', 'S', 'H') };
+//       constexpr static u32 SerialVersion{ 2 };
+//
+//       u32             VertexCount;
+//       Vector<u32>     Indices;
+//       f32             Radius;
+//
+//       constexpr static auto SerialFields() {
+//           return std::tuple{
+//               SerialField("VertexCount", &MeshInfo::VertexCount),
+//               SerialField("Indices", &MeshInfo::Indices),
+//               SerialField("Radius", &MeshInfo::Radius, 2),     // Added in version 2
+//           };
+//       }
+//
+//       void OnSerialUpgrade(u32 FromVersion);                 // Optional, runs after reading older data
+//   };
+//
+// Integers are LEB128 varints, signed ones zigzag encoded, floats are stored as is. Arrays of
+// arithmetic types, and of structs without fields or padding, are copied in one go. Structs
+// holding floats have no unique byte representation, they list their fields like any other.
+// Every object starts with its version, fields added after the stored version keep their default.
+namespace Iron {
+static_assert(std::endian::native == std::endian::little, "Serialized data is little endian");
+
+constexpr u32
+MakeFourCC(char A, char B, char C, char D) {
+    return (u32)(u8)A | ((u32)(u8)B << 8) | ((u32)(u8)C << 16) | ((u32)(u8)D << 24);
+}
+
+template<typename C, typename M>
+struct SerialFieldInfo {
+    const char*     Name;
+    M C::*          Member;
+    u32             Since;
+};
+
+template<typename C, typename M>
+constexpr SerialFieldInfo<C, M>
+SerialField(const char* Name, M C::* Member, u32 Since = 1) {
+    return { Name, Member, Since };
+}
+
+/// Bytes read in place, they point into the buffer being read and stay valid as long as it does
+template<typename T>
+struct SerialView {
+    static_assert(alignof(T) == 1 && std::is_trivially_copyable_v<T>, "Views can't be aligned");
+
+    const T*    Data;
+    u64         Count;
+};
+
+namespace Detail {
+template<typename T>
+concept HasSerialFields = requires { T::SerialFields(); };
+
+template<typename T>
+concept HasSerialUpgrade = requires(T& Value, u32 From) { Value.OnSerialUpgrade(From); };
+
+template<typename T>
+constexpr u32
+SerialVersionOf() {
+    if constexpr (requires { T::SerialVersion; }) {
+        return T::SerialVersion;
+    }
+    else {
+        return 1;
+    }
+}
+
+// Stored with one copy, alone or as array elements. Padding would copy uninitialized bytes
+// into the file, so only types where every byte belongs to a value qualify
+template<typename T>
+constexpr bool IsRawSerial{ std::is_trivially_copyable_v<T> && std::is_class_v<T> && !HasSerialFields<T>
+    && std::has_unique_object_representations_v<T> };
+
+template<typename T>
+constexpr bool IsBulkSerial{ (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) || IsRawSerial<T> };
+
+template<typename T>
+struct IsSerialVector : std::false_type {};
+
+template<typename T, bool D, u32 A, typename Alloc>
+struct IsSerialVector<Vector<T, D, A, Alloc>> : std::true_type {};
+
+template<typename T, u32 N, bool D>
+struct IsSerialVector<InlineVector<T, N, D>> : std::true_type {};
+
+template<typename T>
+struct IsSerialView : std::false_type {};
+
+template<typename T>
+struct IsSerialView<SerialView<T>> : std::true_type {};
+
+template<typename T>
+constexpr bool AlwaysFalse{ false };
+}
+
+template<typename T>
+bool Serialize(StreamWriter& Writer, const T& Value);
+
+template<typename T>
+bool Deserialize(StreamReader& Reader, T& Value);
+
+namespace Detail {
+template<typename T>
+bool
+SerializeElements(StreamWriter& Writer, const T* Data, u64 Count) {
+    if constexpr (IsBulkSerial<T>) {
+        return Writer.Write(Data, Count * sizeof(T));
+    }
+    else {
+        for (u64 I{ 0 }; I < Count; ++I) {
+            if (!Serialize(Writer, Data[I])) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+template<typename T>
+bool
+DeserializeElements(StreamReader& Reader, T* Data, u64 Count) {
+    if constexpr (IsBulkSerial<T>) {
+        return Reader.Read(Data, Count * sizeof(T));
+    }
+    else {
+        for (u64 I{ 0 }; I < Count; ++I) {
+            if (!Deserialize(Reader, Data[I])) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+// Rejects counts the remaining data can't hold before anything is allocated
+template<typename T>
+bool
+ReadCount(StreamReader& Reader, u64& Count) {
+    constexpr u64 MinSize{ IsBulkSerial<T> ? sizeof(T) : 1 };
+    return Reader.ReadVarU64(Count) && Count <= Reader.Remaining() / MinSize && Count <= max_u32;
+}
+}
+
+template<typename T>
+bool
+Serialize(StreamWriter& Writer, const T& Value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        return Writer.Write((u8)(Value ? 1 : 0));
+    }
+    else if constexpr (std::is_enum_v<T>) {
+        return Serialize(Writer, (std::underlying_type_t<T>)Value);
+    }
+    else if constexpr (std::is_integral_v<T> && sizeof(T) == 1) {
+        return Writer.Write(Value);
+    }
+    else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        return Writer.WriteVarS64((s64)Value);
+    }
+    else if constexpr (std::is_integral_v<T>) {
+        return Writer.WriteVarU64((u64)Value);
+    }
+    else if constexpr (std::is_floating_point_v<T>) {
+        return Writer.Write(Value);
+    }
+    else if constexpr (std::is_array_v<T>) {
+        return Detail::SerializeElements(Writer, &Value[0], std::extent_v<T>);
+    }
+    else if constexpr (Detail::IsSerialVector<T>::value) {
+        return Writer.WriteVarU64(Value.Size()) && Detail::SerializeElements(Writer, Value.Data(), Value.Size());
+    }
+    else if constexpr (Detail::IsSerialView<T>::value) {
+        return Writer.WriteVarU64(Value.Count) && Detail::SerializeElements(Writer, Value.Data, Value.Count);
+    }
+    else if constexpr (Detail::HasSerialFields<T>) {
+        if (!Writer.WriteVarU64(Detail::SerialVersionOf<T>())) {
+            return false;
+        }
+
+        return std::apply([&](const auto&... Fields) {
+            return (Serialize(Writer, Value.*Fields.Member) && ...);
+        }, T::SerialFields());
+    }
+    else if constexpr (Detail::IsRawSerial<T>) {
+        return Writer.Write(Value);
+    }
+    else {
+        static_assert(Detail::AlwaysFalse<T>, "Type has no serialization or has padding, add SerialFields()");
+        return false;
+    }
+}
+
+template<typename T>
+bool
+Deserialize(StreamReader& Reader, T& Value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        u8 Byte{ 0 };
+        if (!Reader.Read(Byte) || Byte > 1) {
+            return false;
+        }
+        Value = Byte != 0;
+        return true;
+    }
+    else if constexpr (std::is_enum_v<T>) {
+        std::underlying_type_t<T> Underlying{};
+        if (!Deserialize(Reader, Underlying)) {
+            return false;
+        }
+        Value = (T)Underlying;
+        return true;
+    }
+    else if constexpr (std::is_integral_v<T> && sizeof(T) == 1) {
+        return Reader.Read(Value);
+    }
+    else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        s64 Wide{ 0 };
+        if (!Reader.ReadVarS64(Wide) || Wide < (s64)std::numeric_limits<T>::min() || Wide > (s64)std::numeric_limits<T>::max()) {
+            return false;
+        }
+        Value = (T)Wide;
+        return true;
+    }
+    else if constexpr (std::is_integral_v<T>) {
+        u64 Wide{ 0 };
+        if (!Reader.ReadVarU64(Wide) || Wide > (u64)std::numeric_limits<T>::max()) {
+            return false;
+        }
+        Value = (T)Wide;
+        return true;
+    }
+    else if constexpr (std::is_floating_point_v<T>) {
+        return Reader.Read(Value);
+    }
+    else if constexpr (std::is_array_v<T>) {
+        return Detail::DeserializeElements(Reader, &Value[0], std::extent_v<T>);
+    }
+    else if constexpr (Detail::IsSerialVector<T>::value) {
+        using E = std::remove_cvref_t<decltype(*Value.Data())>;
+        u64 Count{ 0 };
+        if (!Detail::ReadCount<E>(Reader, Count)) {
+            return false;
+        }
+        Value.Resize((u32)Count);
+        return Detail::DeserializeElements(Reader, Value.Data(), Count);
+    }
+    else if constexpr (Detail::IsSerialView<T>::value) {
+        using E = std::remove_cvref_t<decltype(*Value.Data)>;
+        u64 Count{ 0 };
+        if (!Detail::ReadCount<E>(Reader, Count)) {
+            return false;
+        }
+        Value.Data = (const E*)Reader.Take(Count * sizeof(E));
+        Value.Count = Count;
+        return Value.Data != nullptr || !Count;
+    }
+    else if constexpr (Detail::HasSerialFields<T>) {
+        u64 Version{ 0 };
+        if (!Reader.ReadVarU64(Version) || !Version || Version > Detail::SerialVersionOf<T>()) {
+            return false;
+        }
+
+        const bool Read{ std::apply([&](const auto&... Fields) {
+            return ((Fields.Since > Version || Deserialize(Reader, Value.*Fields.Member)) && ...);
+        }, T::SerialFields()) };
+        if (!Read) {
+            return false;
+        }
+
+        if constexpr (Detail::HasSerialUpgrade<T>) {
+            if (Version < Detail::SerialVersionOf<T>()) {
+                Value.OnSerialUpgrade((u32)Version);
+            }
+        }
+        return true;
+    }
+    else if constexpr (Detail::IsRawSerial<T>) {
+        return Reader.Read(Value);
+    }
+    else {
+        static_assert(Detail::AlwaysFalse<T>, "Type has no serialization or has padding, add SerialFields()");
+        return false;
+    }
+}
+
+/// Magic of T then Value, the layout of every cooked file
+template<typename T>
+bool
+WriteSerialized(StreamWriter& Writer, const T& Value) {
+    return Writer.Write(T::SerialMagic) && Serialize(Writer, Value);
+}
+
+/// Views in Value point into Data
+template<typename T>
+Result::Code
+ReadSerialized(const u8* Data, u64 Size, T& Value) {
+    if (!Data) {
+        return Result::ENullptr;
+    }
+
+    StreamReader Reader{ Data, Size };
+    u32 Magic{ 0 };
+    if (!Reader.Read(Magic) || Magic != T::SerialMagic || !Deserialize(Reader, Value)) {
+        return Result::EInvalidData;
+    }
+    return Result::Ok;
+}
+
+template<typename T>
+Result::Code
+SaveSerialized(const char* Path, const T& Value, u32 Flags = FileWriteFlags::None) {
+    StreamWriter Writer{};
+    if (!WriteSerialized(Writer, Value)) {
+        return Result::ENomemory;
+    }
+
+    FileWriter File{};
+    Result::Code Res{ File.Open(Path, Flags, Math::Min(Writer.Offset(), FileWriter::DefaultBufferSize)) };
+    if (Result::Fail(Res)) {
+        return Res;
+    }
+
+    Res = File.Write(Writer.Data(), Writer.Offset());
+    return Result::Fail(Res) ? Res : File.Commit();
+}
+}
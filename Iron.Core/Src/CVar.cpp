@@ -0,0 +1,299 @@
+#include <Iron.Core/CVar.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+namespace Iron {
+// The index is needed until the last static CVar is destroyed, the leak report skips it
+using CVarIndex = HashMap<u64, CVarBase*, Hasher<u64>, EqualTo, TaggedAllocator<MemTag::Static>>;
+
+// Registration and callbacks are rare, one lock covers them. Reads never touch it.
+struct CVarRegistry {
+    std::recursive_mutex        Lock;
+    CVarIndex                   Index;
+    CVarBase*                   Head{};
+    const ConfigFile*           Config{};
+
+    static u64 Hash(const char* Section, const char* Name) {
+        // Same as Fnv1A over "Section.Name" without building the string
+        u64 Hash{ 14695981039346656037ull };
+        for (const char* C{ Section }; *C; ++C) {
+            Hash = (Hash ^ (u8)*C) * 1099511628211ull;
+        }
+        Hash = (Hash ^ (u8)'.') * 1099511628211ull;
+        for (const char* C{ Name }; *C; ++C) {
+            Hash = (Hash ^ (u8)*C) * 1099511628211ull;
+        }
+        return Hash;
+    }
+
+    static bool Load(CVarBase& Var, const ConfigFile& Config) {
+        const char* Value{ Config.Get(Var.m_Section, Var.m_Name) };
+        if (Value && !Var.SetFromString(Value)) {
+            LOG_WARNING("Invalid value %s for %s.%s", Value, Var.m_Section, Var.m_Name);
+            return false;
+        }
+        return true;
+    }
+
+    void Register(CVarBase& Var) {
+        std::lock_guard Guard{ Lock };
+        if (Index.Contains(Var.m_Hash)) {
+            LOG_ERROR("CVar %s.%s is already registered", Var.m_Section, Var.m_Name);
+            return;
+        }
+
+        Index.Emplace(Var.m_Hash, &Var);
+        Var.m_Next = Head;
+        Head = &Var;
+
+        if (Config) {
+            Load(Var, *Config);
+        }
+    }
+
+    template<typename F>
+    void Visit(F Func) {
+        std::lock_guard Guard{ Lock };
+        for (CVarBase* Var{ Head }; Var; Var = Var->m_Next) {
+            Func(*Var);
+        }
+    }
+
+    void Unregister(CVarBase& Var) {
+        std::lock_guard Guard{ Lock };
+        CVarBase* const* Found{ Index.Find(Var.m_Hash) };
+        if (!Found || *Found != &Var) {
+            return;
+        }
+
+        Index.Erase(Var.m_Hash);
+        for (CVarBase** Link{ &Head }; *Link; Link = &(*Link)->m_Next) {
+            if (*Link == &Var) {
+                *Link = Var.m_Next;
+                break;
+            }
+        }
+    }
+};
+
+namespace {
+// Function local so variables in other static initializers can register safely
+CVarRegistry&
+GetRegistry() {
+    static CVarRegistry Registry{};
+    return Registry;
+}
+} // anonymous namespace
+
+CVarBase::CVarBase(const char* Section, const char* Name, const char* Description,
+    CVarType::Type Type, u32 DefaultBits, u32 Flags)
+    : m_Bits(DefaultBits),
+    m_Section(Section),
+    m_Name(Name),
+    m_Description(Description ? Description : ""),
+    m_Type(Type),
+    m_Flags(Flags),
+    m_DefaultBits(DefaultBits),
+    m_Hash(CVarRegistry::Hash(Section, Name)) {
+    GetRegistry().Register(*this);
+}
+
+CVarBase::~CVarBase() {
+    GetRegistry().Unregister(*this);
+}
+
+bool
+CVarBase::SetFromString(const char* Value) {
+    if (!Value) {
+        return false;
+    }
+
+    char* End{ nullptr };
+    u32 Bits{ 0 };
+
+    switch (m_Type) {
+    case CVarType::Bool:
+        if (!_stricmp(Value, "1") || !_stricmp(Value, "true") || !_stricmp(Value, "yes") || !_stricmp(Value, "on")) {
+            Bits = 1;
+        }
+        else if (_stricmp(Value, "0") && _stricmp(Value, "false") && _stricmp(Value, "no") && _stricmp(Value, "off")) {
+            return false;
+        }
+        break;
+    case CVarType::Int:
+        Bits = (u32)(s32)strtol(Value, &End, 10);
+        if (End == Value || *End) {
+            return false;
+        }
+        break;
+    case CVarType::Float:
+        Bits = std::bit_cast<u32>(strtof(Value, &End));
+        if (End == Value || *End) {
+            return false;
+        }
+        break;
+    default:
+        return false;
+    }
+
+    SetBits(Bits);
+    return true;
+}
+
+u32
+CVarBase::ToString(char* Buffer, u32 Size) const {
+    if (!Buffer || !Size) {
+        return 0;
+    }
+
+    const u32 Bits{ m_Bits.load(std::memory_order_relaxed) };
+    s32 Length{ 0 };
+
+    switch (m_Type) {
+    case CVarType::Bool:
+        Length = snprintf(Buffer, Size, "%u", Bits ? 1u : 0u);
+        break;
+    case CVarType::Int:
+        Length = snprintf(Buffer, Size, "%d", (s32)Bits);
+        break;
+    case CVarType::Float:
+        Length = snprintf(Buffer, Size, "%g", std::bit_cast<f32>(Bits));
+        break;
+    default:
+        Buffer[0] = 0;
+        break;
+    }
+
+    return Length < 0 ? 0 : Math::Min((u32)Length, Size - 1);
+}
+
+void
+CVarBase::Reset() {
+    SetBits(m_DefaultBits);
+}
+
+bool
+CVarBase::AddCallback(CVarCallback Callback, void* UserData) {
+    if (!Callback) {
+        return false;
+    }
+
+    std::lock_guard Guard{ GetRegistry().Lock };
+    if (m_CallbackCount == MaxCVarCallbacks) {
+        return false;
+    }
+
+    m_Callbacks[m_CallbackCount++] = { Callback, UserData };
+    return true;
+}
+
+void
+CVarBase::RemoveCallback(CVarCallback Callback, void* UserData) {
+    std::lock_guard Guard{ GetRegistry().Lock };
+    for (u32 I{ 0 }; I < m_CallbackCount; ++I) {
+        if (m_Callbacks[I].Func == Callback && m_Callbacks[I].UserData == UserData) {
+            m_Callbacks[I] = m_Callbacks[--m_CallbackCount];
+            return;
+        }
+    }
+}
+
+void
+CVarBase::SetBits(u32 Bits) {
+    if (m_Bits.exchange(Bits, std::memory_order_relaxed) == Bits) {
+        return;
+    }
+
+    // Copied out so callbacks may add or remove callbacks and set other variables
+    Callback Callbacks[MaxCVarCallbacks];
+    u32 Count{ 0 };
+    {
+        std::lock_guard Guard{ GetRegistry().Lock };
+        Count = m_CallbackCount;
+        MemCopy(Callbacks, m_Callbacks, sizeof(Callback) * Count);
+    }
+
+    for (u32 I{ 0 }; I < Count; ++I) {
+        Callbacks[I].Func(*this, Callbacks[I].UserData);
+    }
+}
+
+CVarBase*
+FindCVar(const char* FullName) {
+    if (!FullName) {
+        return nullptr;
+    }
+
+    CVarRegistry& Registry{ GetRegistry() };
+    std::lock_guard Guard{ Registry.Lock };
+    CVarBase* const* Found{ Registry.Index.Find(Fnv1A(FullName)) };
+    if (!Found) {
+        return nullptr;
+    }
+
+    // Guard against hash collisions, the stored name is split at the section dot
+    const CVarBase& Var{ **Found };
+    const size_t SectionLength{ StrLen(Var.GetSection()) };
+    if (strncmp(FullName, Var.GetSection(), SectionLength) || FullName[SectionLength] != '.'
+        || strcmp(FullName + SectionLength + 1, Var.GetName())) {
+        return nullptr;
+    }
+
+    return *Found;
+}
+
+Result::Code
+SetCVar(const char* FullName, const char* Value) {
+    CVarBase* Var{ FindCVar(FullName) };
+    if (!Var || (Var->GetFlags() & CVarFlags::ReadOnly)) {
+        return Result::EInvalidarg;
+    }
+
+    return Var->SetFromString(Value) ? Result::Ok : Result::EInvalidarg;
+}
+
+void
+ForEachCVar(void(*Func)(CVarBase& Var, void* UserData), void* UserData) {
+    if (!Func) {
+        return;
+    }
+
+    GetRegistry().Visit([&](CVarBase& Var) {
+        Func(Var, UserData);
+    });
+}
+
+void
+LoadCVars(const ConfigFile& Config) {
+    GetRegistry().Visit([&](CVarBase& Var) {
+        CVarRegistry::Load(Var, Config);
+    });
+}
+
+void
+SaveCVars(ConfigFile& Config) {
+    GetRegistry().Visit([&](CVarBase& Var) {
+        if ((Var.GetFlags() & CVarFlags::NoSave)
+            || ((Var.GetFlags() & CVarFlags::ReadOnly) && Config.Get(Var.GetSection(), Var.GetName()))) {
+            return;
+        }
+
+        char Value[32];
+        Var.ToString(Value, sizeof(Value));
+        Config.Set(Var.GetSection(), Var.GetName(), Value);
+    });
+}
+
+void
+BindCVarConfig(const ConfigFile* Config) {
+    CVarRegistry& Registry{ GetRegistry() };
+    std::lock_guard Guard{ Registry.Lock };
+    Registry.Config = Config;
+    if (Config) {
+        LoadCVars(*Config);
+    }
+}
+}
@@ -1,110 +1,77 @@
 #include <Iron.Core/Core.h>
 
-#include <algorithm>
+#include <cstdio>
 #include <cstdlib>
-#include <ctype.h>
+#include <cstring>
 
 namespace Iron {
 namespace {
-static void ParseLine(ConfigFile& Cfg, char* Line, char*& CurrentSection) {
-    Line = Trim(Line);
-    if (!Line || *Line == '\0')
-        return;
+constexpr u64 MinBlockSize{ 4 * 1024 };
 
-    if (*Line == ';' || *Line == '#')
-        return;
+constexpr u8 ValidInt{ 1 << 0 };
+constexpr u8 ValidFloat{ 1 << 1 };
+constexpr u8 ValidBool{ 1 << 2 };
 
-    if (*Line == '[') {
-        char* End{ strchr(Line, ']') };
-        if (!End) return;
+inline u64
+KeywordHash(const char* Keyword, u32 Section) {
+    return Fnv1A(Keyword) ^ ((u64)(Section + 1) * 0x9e3779b97f4a7c15ull);
+}
 
-        *End = '\0';
-        CurrentSection = Trim(Line + 1);
-        return;
+bool
+ParseBool(const char* Value, bool& Out) {
+    if (!_stricmp(Value, "1") || !_stricmp(Value, "true") || !_stricmp(Value, "yes") || !_stricmp(Value, "on")) {
+        Out = true;
+        return true;
     }
 
-    char* Equal{ strchr(Line, '=') };
-    if (!Equal) return;
-
-    *Equal = '\0';
-    char* Key = Trim(Line);
-    char* Value = Trim(Equal + 1);
-
-    if (!CurrentSection)
-        CurrentSection = (char*)"default";
+    if (!_stricmp(Value, "0") || !_stricmp(Value, "false") || !_stricmp(Value, "no") || !_stricmp(Value, "off")) {
+        Out = false;
+        return true;
+    }
 
-    Cfg.Set(CurrentSection, Key, Value);
+    return false;
 }
+} // anonymous namespace
 
-static void ParseBuffer(ConfigFile& Cfg, const char* Buffer) {
-    if (!Buffer) return;
-
-    const size_t Len{ StrLen(Buffer) + 1 };
-    char* Copy{ (char*)MemAlloc(Len) };
-    if (!Copy) return;
-    strcpy_s(Copy, Len, Buffer);
-
-    char* CurrentSection{ nullptr };
-    char* Line{ Copy };
-
-    while (*Line) {
-        char* Next{ strchr(Line, '\n') };
-        if (Next) {
-            *Next = '\0';
-            ++Next;
-        }
-        ParseLine(Cfg, Line, CurrentSection);
-        Line = Next;
-    }
+bool
+ConfigFile::KeyEqual::operator()(const Key& Lhs, const Key& Rhs) const noexcept {
+    return Lhs.Hash == Rhs.Hash && Lhs.Section == Rhs.Section && !std::strcmp(Lhs.Name, Rhs.Name);
+}
 
-    MemFree(Copy);
+ConfigFile::~ConfigFile()
+{
+    Clear();
 }
 
-static bool ParseFile(ConfigFile& Cfg, const char* Path) {
-    if (!Path) return false;
+Result::Code
+ConfigFile::Load(const char* File) {
+    if (!File) return Result::EInvalidarg;
 
     FILE* F{ nullptr };
-    fopen_s(&F, Path, "r");
-
-    if (!F) return false;
+    fopen_s(&F, File, "r");
+    if (!F) return Result::ELoadfile;
 
     fseek(F, 0, SEEK_END);
-    long Size{ std::ftell(F) };
+    const long Size{ std::ftell(F) };
     fseek(F, 0, SEEK_SET);
 
     if (Size <= 0) {
         fclose(F);
-        return false;
+        return Result::ELoadfile;
     }
 
-    char* Buffer{ (char*)MemAlloc(Size + 1) };
+    // The text stays in the string blocks, entries point straight into it
+    char* Buffer{ AllocString((u64)Size + 1) };
     if (!Buffer) {
         fclose(F);
-        return false;
+        return Result::ENomemory;
     }
 
-    size_t Read{ fread(Buffer, 1, Size, F) };
+    const size_t Read{ fread(Buffer, 1, Size, F) };
     Buffer[Read] = '\0';
     fclose(F);
 
-    ParseBuffer(Cfg, Buffer);
-    MemFree(Buffer);
-
-    return true;
-}
-} // anonymous namespace
-
-
-ConfigFile::~ConfigFile()
-{
-    Clear();
-}
-
-Result::Code
-ConfigFile::Load(const char* File) {
-    if (!ParseFile(*this, File)) {
-        return Result::ELoadfile;
-    }
+    ParseBuffer(Buffer);
 
     LOG_INFO("Loaded config file %s", File);
 
@@ -115,24 +82,33 @@ Result::Code
 ConfigFile::Save(const char* Path) const {
     if (!Path) return Result::EInvalidarg;
 
-    FILE* F{ nullptr };
-    fopen_s(&F, Path, "w");
-    if (!F) return Result::EWritefile;
+    // A crash while saving keeps the previous file
+    FileWriter Writer{};
+    Result::Code Res{ Writer.Open(Path, FileWriteFlags::None, 16 * 1024) };
+    if (Result::Fail(Res)) return Res;
 
-    const char* CurrentSection{ nullptr };
+    const auto Put{ [&](const char* Str) { Writer.Write(Str, StrLen(Str)); } };
 
-    for (u32 I{ 0 }; I < m_Entries.Size(); ++I) {
-        const Entry& E{ m_Entries[I] };
-
-        if (!CurrentSection || std::strcmp(CurrentSection, E.Section) != 0) {
-            CurrentSection = E.Section;
-            fprintf(F, "[%s]\n", CurrentSection);
+    for (u32 S{ 0 }; S < m_Sections.Size(); ++S) {
+        const SectionInfo& Section{ m_Sections[S] };
+        if (Section.First == max_u32) {
+            continue;
         }
 
-        fprintf(F, "%s=%s\n", E.Keyword, E.Value);
+        Put("[");
+        Put(Section.Name);
+        Put("]\n");
+
+        for (u32 I{ Section.First }; I != max_u32; I = m_Entries[I].Next) {
+            Put(m_Entries[I].Keyword);
+            Put("=");
+            Put(m_Entries[I].Value);
+            Put("\n");
+        }
     }
 
-    fclose(F);
+    Res = Writer.Commit();
+    if (Result::Fail(Res)) return Res;
 
     LOG_INFO("Saved config file to %s", Path);
 
@@ -147,22 +123,40 @@ ConfigFile::Set(
     if (!Section || !Keyword)
         return;
 
-    for (u32 I{ 0 }; I < m_Entries.Size(); ++I) {
-        Entry& E{ m_Entries[I] };
-        if (std::strcmp(E.Section, Section) == 0 &&
-            std::strcmp(E.Keyword, Keyword) == 0)
-        {
-            MemFree((void*)E.Value);
-            E.Value = StrDup(Value ? Value : "");
+    if (!Value)
+        Value = "";
+
+    const u64 SectionHash{ Fnv1A(Section) };
+    u32 SectionIndex{ FindSection(Section, SectionHash) };
+    if (SectionIndex == max_u32) {
+        const char* Name{ CopyString(Section) };
+        if (!Name) return;
+        SectionIndex = AddSection(Name, SectionHash);
+    }
+
+    const u32 Length{ (u32)StrLen(Value) + 1 };
+    const u32* Found{ m_Index.Find(Key{ KeywordHash(Keyword, SectionIndex), Keyword, SectionIndex }) };
+    if (Found) {
+        // Overwrite in place while the new value fits, repeated sets don't grow the blocks
+        Entry& E{ m_Entries[*Found] };
+        if (Length <= E.ValueCapacity) {
+            MemCopy((void*)E.Value, Value, Length);
+            ParseValue(E);
             return;
         }
+
+        const char* Copy{ CopyString(Value) };
+        if (Copy) {
+            SetInterned(SectionIndex, E.Keyword, Copy, Length);
+        }
+        return;
     }
 
-    Entry E{};
-    E.Section = StrDup(Section ? Section : "");
-    E.Keyword = StrDup(Keyword ? Keyword : "");
-    E.Value = StrDup(Value ? Value : "");
-    m_Entries.PushBack(E);
+    const char* KeywordCopy{ CopyString(Keyword) };
+    const char* ValueCopy{ CopyString(Value) };
+    if (KeywordCopy && ValueCopy) {
+        SetInterned(SectionIndex, KeywordCopy, ValueCopy, Length);
+    }
 }
 
 const char*
@@ -170,28 +164,282 @@ ConfigFile::Get(
     const char* Section,
     const char* Keyword,
     const char* DefaultValue) const {
-    if (!Section || !Keyword)
-        return DefaultValue;
-
-    for (u32 I{ 0 }; I < m_Entries.Size(); ++I) {
-        const Entry& E{ m_Entries[I] };
-        if (std::strcmp(E.Section, Section) == 0 &&
-            std::strcmp(E.Keyword, Keyword) == 0)
-        {
-            return E.Value;
+    const Entry* E{ FindEntry(Section, Keyword) };
+    return E ? E->Value : DefaultValue;
+}
+
+s32
+ConfigFile::GetInt(const char* Section, const char* Keyword, s32 DefaultValue) const {
+    const Entry* E{ FindEntry(Section, Keyword) };
+    return E && (E->Valid & ValidInt) ? E->Int : DefaultValue;
+}
+
+f32
+ConfigFile::GetFloat(const char* Section, const char* Keyword, f32 DefaultValue) const {
+    const Entry* E{ FindEntry(Section, Keyword) };
+    return E && (E->Valid & ValidFloat) ? E->Float : DefaultValue;
+}
+
+bool
+ConfigFile::GetBool(const char* Section, const char* Keyword, bool DefaultValue) const {
+    const Entry* E{ FindEntry(Section, Keyword) };
+    return E && (E->Valid & ValidBool) ? E->Bool : DefaultValue;
+}
+
+u32
+ConfigFile::Merge(const ConfigFile& Other, ConfigChangeCallback Callback, void* UserData) {
+    u32 Changed{ 0 };
+    for (u32 S{ 0 }; S < Other.m_Sections.Size(); ++S) {
+        const SectionInfo& Section{ Other.m_Sections[S] };
+        for (u32 I{ Section.First }; I != max_u32; I = Other.m_Entries[I].Next) {
+            const Entry& E{ Other.m_Entries[I] };
+            const char* Current{ Get(Section.Name, E.Keyword) };
+            if (Current && !std::strcmp(Current, E.Value)) {
+                continue;
+            }
+
+            Set(Section.Name, E.Keyword, E.Value);
+            ++Changed;
+
+            if (Callback) {
+                Callback(Section.Name, E.Keyword, E.Value, UserData);
+            }
         }
     }
 
-    return DefaultValue;
+    return Changed;
+}
+
+Result::Code
+ConfigFile::Reload(const char* File, ConfigChangeCallback Callback, void* UserData) {
+    ConfigFile Latest{};
+    const Result::Code Res{ Latest.Load(File) };
+    if (Result::Fail(Res)) {
+        return Res;
+    }
+
+    const u32 Changed{ Merge(Latest, Callback, UserData) };
+    LOG_INFO("Reloaded config file %s, %u changed", File, Changed);
+
+    return Result::Ok;
+}
+
+Result::Code
+ConfigFile::SaveChanges(const char* Path, const ConfigFile& AsRead) const {
+    ConfigFile Latest{};
+    if (Result::Fail(Latest.Load(Path))) {
+        return Save(Path);
+    }
+
+    for (u32 S{ 0 }; S < m_Sections.Size(); ++S) {
+        const SectionInfo& Section{ m_Sections[S] };
+        for (u32 I{ Section.First }; I != max_u32; I = m_Entries[I].Next) {
+            const Entry& E{ m_Entries[I] };
+            const char* Before{ AsRead.Get(Section.Name, E.Keyword) };
+            if (!Before || std::strcmp(Before, E.Value)) {
+                Latest.Set(Section.Name, E.Keyword, E.Value);
+            }
+        }
+    }
+
+    return Latest.Save(Path);
 }
 
 void
 ConfigFile::Clear() {
-    for (u32 I{ 0 }; I < m_Entries.Size(); ++I) {
-        MemFree((void*)m_Entries[I].Section);
-        MemFree((void*)m_Entries[I].Keyword);
-        MemFree((void*)m_Entries[I].Value);
+    m_Index = {};
+    m_Entries = {};
+    m_Sections = {};
+
+    while (m_Blocks) {
+        Block* Prev{ m_Blocks->Prev };
+        MemFree(m_Blocks);
+        m_Blocks = Prev;
+    }
+
+    m_Cursor = nullptr;
+    m_Remaining = 0;
+}
+
+char*
+ConfigFile::AllocString(u64 Size) {
+    if (Size > m_Remaining) {
+        // Large requests like a loaded file get a block of their own, the current one stays in use
+        const u64 BlockSize{ Math::Max(Size, MinBlockSize) };
+        Block* B{ (Block*)MemAlloc(sizeof(Block) + BlockSize) };
+        if (!B) return nullptr;
+
+        B->Prev = m_Blocks;
+        B->Size = BlockSize;
+        m_Blocks = B;
+
+        if (BlockSize - Size < m_Remaining) {
+            return (char*)(B + 1);
+        }
+
+        m_Cursor = (char*)(B + 1);
+        m_Remaining = BlockSize;
+    }
+
+    char* Out{ m_Cursor };
+    m_Cursor += Size;
+    m_Remaining -= Size;
+    return Out;
+}
+
+const char*
+ConfigFile::CopyString(const char* Str) {
+    const u64 Size{ StrLen(Str) + 1 };
+    char* Out{ AllocString(Size) };
+    if (Out) {
+        MemCopy(Out, Str, Size);
+    }
+    return Out;
+}
+
+u32
+ConfigFile::FindSection(const char* Name, u64 Hash) const {
+    const u32* Found{ m_Index.Find(Key{ Hash, Name, max_u32 }) };
+    return Found ? *Found : max_u32;
+}
+
+u32
+ConfigFile::AddSection(const char* Name, u64 Hash) {
+    const u32 Index{ m_Sections.Size() };
+    m_Sections.PushBack({ Name, max_u32, max_u32 });
+    m_Index.Emplace(Key{ Hash, Name, max_u32 }, Index);
+    return Index;
+}
+
+const ConfigFile::Entry*
+ConfigFile::FindEntry(const char* Section, const char* Keyword) const {
+    if (!Section || !Keyword)
+        return nullptr;
+
+    const u32 SectionIndex{ FindSection(Section, Fnv1A(Section)) };
+    if (SectionIndex == max_u32)
+        return nullptr;
+
+    const u32* Found{ m_Index.Find(Key{ KeywordHash(Keyword, SectionIndex), Keyword, SectionIndex }) };
+    return Found ? &m_Entries[*Found] : nullptr;
+}
+
+// Every write of a value parses it, so the const getters never write and can run concurrently
+void
+ConfigFile::ParseValue(Entry& E) {
+    char* End{ nullptr };
+    E.Valid = 0;
+
+    E.Int = (s32)strtol(E.Value, &End, 10);
+    if (End != E.Value && !*End) {
+        E.Valid |= ValidInt;
+    }
+
+    E.Float = strtof(E.Value, &End);
+    if (End != E.Value && !*End) {
+        E.Valid |= ValidFloat;
+    }
+
+    if (ParseBool(E.Value, E.Bool)) {
+        E.Valid |= ValidBool;
+    }
+}
+
+// Keyword and Value must already live in the string blocks
+void
+ConfigFile::SetInterned(u32 Section, const char* Keyword, const char* Value, u32 ValueCapacity) {
+    const Key K{ KeywordHash(Keyword, Section), Keyword, Section };
+    if (u32* Found{ m_Index.Find(K) }) {
+        Entry& E{ m_Entries[*Found] };
+        E.Value = Value;
+        E.ValueCapacity = ValueCapacity;
+        ParseValue(E);
+        return;
+    }
+
+    const u32 Index{ m_Entries.Size() };
+    Entry E{};
+    E.Keyword = Keyword;
+    E.Value = Value;
+    E.ValueCapacity = ValueCapacity;
+    E.Section = Section;
+    E.Next = max_u32;
+    ParseValue(E);
+    m_Entries.PushBack(E);
+
+    SectionInfo& S{ m_Sections[Section] };
+    if (S.Last == max_u32) {
+        S.First = Index;
+    }
+    else {
+        m_Entries[S.Last].Next = Index;
+    }
+    S.Last = Index;
+
+    m_Index.Emplace(K, Index);
+}
+
+void
+ConfigFile::ParseBuffer(char* Buffer) {
+    u32 Lines{ 1 };
+    for (const char* C{ Buffer }; *C; ++C) {
+        Lines += *C == '\n';
+    }
+
+    m_Entries.Reserve(m_Entries.Size() + Lines);
+    m_Index.Reserve(m_Index.Size() + Lines);
+
+    u32 CurrentSection{ max_u32 };
+    char* Line{ Buffer };
+
+    while (Line && *Line) {
+        char* Next{ strchr(Line, '\n') };
+        if (Next) {
+            *Next = '\0';
+            ++Next;
+        }
+
+        Line = Trim(Line);
+
+        if (*Line == '\0' || *Line == ';' || *Line == '#') {
+            Line = Next;
+            continue;
+        }
+
+        if (*Line == '[') {
+            char* End{ strchr(Line, ']') };
+            if (End) {
+                *End = '\0';
+                const char* Name{ Trim(Line + 1) };
+                const u64 Hash{ Fnv1A(Name) };
+                CurrentSection = FindSection(Name, Hash);
+                if (CurrentSection == max_u32) {
+                    CurrentSection = AddSection(Name, Hash);
+                }
+            }
+
+            Line = Next;
+            continue;
+        }
+
+        char* Equal{ strchr(Line, '=') };
+        if (Equal) {
+            *Equal = '\0';
+            const char* Keyword{ Trim(Line) };
+            const char* Value{ Trim(Equal + 1) };
+
+            if (CurrentSection == max_u32) {
+                const u64 Hash{ Fnv1A("default") };
+                CurrentSection = FindSection("default", Hash);
+                if (CurrentSection == max_u32) {
+                    CurrentSection = AddSection("default", Hash);
+                }
+            }
+
+            SetInterned(CurrentSection, Keyword, Value, (u32)StrLen(Value) + 1);
+        }
+
+        Line = Next;
     }
-    m_Entries.Clear();
 }
 }
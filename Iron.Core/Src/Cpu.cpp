@@ -0,0 +1,202 @@
+#include <Iron.Core/Core.h>
+
+#include <Windows.h>
+
+namespace Iron {
+namespace {
+u8
+CountBits(u64 Mask) {
+    u8 Count{ 0 };
+    while (Mask) {
+        Mask &= Mask - 1;
+        ++Count;
+    }
+    return Count;
+}
+
+void
+AddCache(CpuCache& Cache, const CACHE_RELATIONSHIP& Info) {
+    Cache.Size = Math::Max(Cache.Size, (u32)Info.CacheSize);
+    Cache.LineSize = Math::Max(Cache.LineSize, (u32)Info.LineSize);
+    ++Cache.Count;
+}
+
+CpuTopology
+QueryTopology() {
+    CpuTopology Topology{};
+
+    DWORD Length{ 0 };
+    GetLogicalProcessorInformationEx(RelationAll, nullptr, &Length);
+
+    u8* Buffer{ Length ? (u8*)MemAlloc(Length, MemTag::Core) : nullptr };
+    if (!Buffer || !GetLogicalProcessorInformationEx(RelationAll,
+        (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)Buffer, &Length)) {
+        MemFree(Buffer, MemTag::Core);
+
+        // Treat every logical processor as its own core
+        SYSTEM_INFO Info{};
+        GetSystemInfo(&Info);
+        const u32 Count{ Math::Min((u32)Info.dwNumberOfProcessors, Math::Min(MaxCpuCores, 64u)) };
+        for (u32 I{ 0 }; I < Count; ++I) {
+            Topology.Cores[I] = { 1ull << I, 0, 1, 0, 0 };
+        }
+
+        Topology.LogicalProcessors = Count;
+        Topology.PhysicalCores = Count;
+        Topology.PerformanceCores = Count;
+        Topology.NumaNodes = 1;
+        return Topology;
+    }
+
+    // Numa nodes come after the cores they contain, so they are matched in a second pass
+    struct NumaRange {
+        u64     Mask;
+        u16     Group;
+        u32     Node;
+    };
+
+    NumaRange Nodes[64]{};
+    u32 NodeCount{ 0 };
+
+    for (DWORD Offset{ 0 }; Offset < Length;) {
+        const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX& Info{
+            *(const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)(Buffer + Offset) };
+
+        switch (Info.Relationship) {
+        case RelationProcessorCore:
+            if (Topology.PhysicalCores < MaxCpuCores) {
+                CpuCore& Core{ Topology.Cores[Topology.PhysicalCores++] };
+                Core.LogicalMask = Info.Processor.GroupMask[0].Mask;
+                Core.Group = Info.Processor.GroupMask[0].Group;
+                Core.LogicalCount = CountBits(Core.LogicalMask);
+                Core.EfficiencyClass = Info.Processor.EfficiencyClass;
+                Topology.LogicalProcessors += Core.LogicalCount;
+            }
+            break;
+        case RelationCache:
+            if (Info.Cache.Level == 1 && Info.Cache.Type == CacheData) {
+                AddCache(Topology.L1Data, Info.Cache);
+            }
+            else if (Info.Cache.Level == 2) {
+                AddCache(Topology.L2, Info.Cache);
+            }
+            else if (Info.Cache.Level == 3) {
+                AddCache(Topology.L3, Info.Cache);
+            }
+            break;
+        case RelationNumaNode:
+            if (NodeCount < _countof(Nodes)) {
+                Nodes[NodeCount++] = { Info.NumaNode.GroupMask.Mask,
+                    Info.NumaNode.GroupMask.Group, (u32)Info.NumaNode.NodeNumber };
+            }
+            break;
+        default:
+            break;
+        }
+
+        Offset += Info.Size;
+    }
+
+    MemFree(Buffer, MemTag::Core);
+
+    Topology.NumaNodes = Math::Max(NodeCount, 1u);
+
+    u8 MinClass{ max_u8 };
+    u8 MaxClass{ 0 };
+    for (u32 I{ 0 }; I < Topology.PhysicalCores; ++I) {
+        CpuCore& Core{ Topology.Cores[I] };
+        for (u32 N{ 0 }; N < NodeCount; ++N) {
+            if (Nodes[N].Group == Core.Group && (Nodes[N].Mask & Core.LogicalMask)) {
+                Core.NumaNode = Nodes[N].Node;
+                break;
+            }
+        }
+
+        MinClass = Math::Min(MinClass, Core.EfficiencyClass);
+        MaxClass = Math::Max(MaxClass, Core.EfficiencyClass);
+    }
+
+    Topology.Hybrid = Topology.PhysicalCores && MinClass != MaxClass;
+
+    // Stable sort, fastest class first, keeps the OS order within a class
+    for (u32 I{ 1 }; I < Topology.PhysicalCores; ++I) {
+        const CpuCore Core{ Topology.Cores[I] };
+        u32 J{ I };
+        for (; J > 0 && Topology.Cores[J - 1].EfficiencyClass < Core.EfficiencyClass; --J) {
+            Topology.Cores[J] = Topology.Cores[J - 1];
+        }
+        Topology.Cores[J] = Core;
+    }
+
+    for (u32 I{ 0 }; I < Topology.PhysicalCores; ++I) {
+        if (Topology.Cores[I].EfficiencyClass == MaxClass) {
+            ++Topology.PerformanceCores;
+        }
+        else {
+            ++Topology.EfficiencyCores;
+        }
+    }
+
+    return Topology;
+}
+} // anonymous namespace
+
+const CpuTopology&
+GetCpuTopology() {
+    static const CpuTopology Topology{ QueryTopology() };
+    return Topology;
+}
+
+void
+SetCurrentThreadName(const char* Name) {
+    if (!Name) {
+        return;
+    }
+
+    wchar_t Wide[64]{};
+    if (MultiByteToWideChar(CP_UTF8, 0, Name, -1, Wide, _countof(Wide))) {
+        SetThreadDescription(GetCurrentThread(), Wide);
+    }
+}
+
+bool
+SetCurrentThreadAffinity(u16 Group, u64 Mask) {
+    if (!Mask) {
+        return false;
+    }
+
+    GROUP_AFFINITY Affinity{};
+    Affinity.Mask = (KAFFINITY)Mask;
+    Affinity.Group = Group;
+    return SetThreadGroupAffinity(GetCurrentThread(), &Affinity, nullptr);
+}
+
+bool
+SetCurrentThreadPriority(ThreadPriority::Priority Priority) {
+    constexpr int Priorities[]{
+        THREAD_PRIORITY_LOWEST,
+        THREAD_PRIORITY_BELOW_NORMAL,
+        THREAD_PRIORITY_NORMAL,
+        THREAD_PRIORITY_ABOVE_NORMAL,
+        THREAD_PRIORITY_HIGHEST,
+        THREAD_PRIORITY_TIME_CRITICAL,
+    };
+
+    if (Priority >= _countof(Priorities)) {
+        return false;
+    }
+
+    return SetThreadPriority(GetCurrentThread(), Priorities[Priority]);
+}
+
+bool
+PinCurrentThreadToCore(u32 CoreIndex) {
+    const CpuTopology& Topology{ GetCpuTopology() };
+    if (CoreIndex >= Topology.PhysicalCores) {
+        return false;
+    }
+
+    const CpuCore& Core{ Topology.Cores[CoreIndex] };
+    return SetCurrentThreadAffinity(Core.Group, Core.LogicalMask);
+}
+}
@@ -0,0 +1,326 @@
+#include <Iron.Core/Core.h>
+
+#include <Windows.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace Iron {
+namespace {
+// WaitForMultipleObjects takes 64 handles, one of them is the wake event
+constexpr u32 MaxWatchedDirs{ 63 };
+constexpr u32 NotifyBufferSize{ 16 * 1024 };
+constexpr u64 SettleMs{ 100 };
+
+struct WatchedDir {
+    char            Path[IRON_MAX_PATH];
+    HANDLE          Handle;
+    HANDLE          Event;
+    OVERLAPPED      Overlapped;
+    u32             Users;
+    bool            Armed;
+    alignas(DWORD) u8 Buffer[NotifyBufferSize];
+};
+
+struct WatchedFile {
+    u32                 Id;
+    WatchedDir*         Dir;
+    char                Path[IRON_MAX_PATH];
+    u32                 NameOffset; // Of the file name in Path
+    FileWatchCallback   Callback;
+    void*               UserData;
+    u64                 ChangedAt;  // Tick of the last change, 0 while unchanged
+};
+
+struct PendingChange {
+    FileWatchCallback   Callback;
+    void*               UserData;
+    char                Path[IRON_MAX_PATH];
+};
+
+struct FileWatcher {
+    std::mutex              Lock;
+    std::thread             Thread;
+    HANDLE                  Wake{};
+    std::atomic<bool>       Quit{};
+    WatchedDir*             Dirs[MaxWatchedDirs]{};
+    u32                     DirCount{ 0 };
+    Vector<WatchedFile>     Files{};
+    u32                     NextId{ 1 };
+};
+
+FileWatcher g_Watch{};
+
+void
+CloseDir(WatchedDir* Dir) {
+    if (Dir->Armed) {
+        // The pending read writes into Dir, it has to finish before Dir is freed
+        DWORD Bytes{ 0 };
+        CancelIoEx(Dir->Handle, &Dir->Overlapped);
+        GetOverlappedResult(Dir->Handle, &Dir->Overlapped, &Bytes, TRUE);
+    }
+
+    CloseHandle(Dir->Handle);
+    CloseHandle(Dir->Event);
+    MemFree(Dir, MemTag::Core);
+}
+
+bool
+ArmDir(WatchedDir* Dir) {
+    constexpr DWORD Filter{ FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE };
+
+    ResetEvent(Dir->Event);
+    Dir->Overlapped = {};
+    Dir->Overlapped.hEvent = Dir->Event;
+    Dir->Armed = ReadDirectoryChangesW(Dir->Handle, Dir->Buffer, NotifyBufferSize, FALSE,
+        Filter, nullptr, &Dir->Overlapped, nullptr);
+    return Dir->Armed;
+}
+
+// Lock held
+void
+MarkChanged(const WatchedDir* Dir, const char* Name, u64 Now) {
+    for (u32 I{ 0 }; I < g_Watch.Files.Size(); ++I) {
+        WatchedFile& File{ g_Watch.Files[I] };
+        if (File.Dir == Dir && (!Name || !_stricmp(File.Path + File.NameOffset, Name))) {
+            File.ChangedAt = Now;
+        }
+    }
+}
+
+void
+ReadChanges(WatchedDir* Dir) {
+    DWORD Bytes{ 0 };
+    const bool Done{ GetOverlappedResult(Dir->Handle, &Dir->Overlapped, &Bytes, FALSE) != 0 };
+    Dir->Armed = false;
+
+    const u64 Now{ GetTickCount64() };
+    std::lock_guard Lock{ g_Watch.Lock };
+
+    // Zero bytes means the buffer overflowed, every file in the directory may have changed
+    if (!Done || !Bytes) {
+        MarkChanged(Dir, nullptr, Now);
+    }
+    else {
+        for (DWORD Offset{ 0 };;) {
+            const FILE_NOTIFY_INFORMATION& Info{ *(const FILE_NOTIFY_INFORMATION*)(Dir->Buffer + Offset) };
+
+            char Name[IRON_MAX_PATH];
+            const s32 Length{ WideCharToMultiByte(CP_UTF8, 0, Info.FileName,
+                (s32)(Info.FileNameLength / sizeof(WCHAR)), Name, sizeof(Name) - 1, nullptr, nullptr) };
+            if (Length > 0) {
+                Name[Length] = 0;
+                MarkChanged(Dir, Name, Now);
+            }
+
+            if (!Info.NextEntryOffset) {
+                break;
+            }
+            Offset += Info.NextEntryOffset;
+        }
+    }
+
+    ArmDir(Dir);
+}
+
+void
+WatcherMain() {
+    SetCurrentThreadName("Iron File Watcher");
+
+    HANDLE Handles[MaxWatchedDirs + 1];
+    WatchedDir* Dirs[MaxWatchedDirs];
+
+    while (!g_Watch.Quit.load(std::memory_order_acquire)) {
+        u32 Count{ 0 };
+        Handles[Count++] = g_Watch.Wake;
+        {
+            std::lock_guard Lock{ g_Watch.Lock };
+            for (u32 I{ 0 }; I < g_Watch.DirCount;) {
+                WatchedDir* Dir{ g_Watch.Dirs[I] };
+
+                // Directories are only closed here, no read can be pending on another thread
+                if (!Dir->Users) {
+                    CloseDir(Dir);
+                    g_Watch.Dirs[I] = g_Watch.Dirs[--g_Watch.DirCount];
+                    continue;
+                }
+
+                if (Dir->Armed || ArmDir(Dir)) {
+                    Dirs[Count - 1] = Dir;
+                    Handles[Count++] = Dir->Event;
+                }
+                ++I;
+            }
+        }
+
+        const DWORD Wait{ WaitForMultipleObjects(Count, Handles, FALSE, INFINITE) };
+        if (Wait > WAIT_OBJECT_0 && Wait < WAIT_OBJECT_0 + Count) {
+            ReadChanges(Dirs[Wait - WAIT_OBJECT_0 - 1]);
+        }
+    }
+}
+
+WatchedDir*
+OpenDir(const char* Path) {
+    for (u32 I{ 0 }; I < g_Watch.DirCount; ++I) {
+        if (!_stricmp(g_Watch.Dirs[I]->Path, Path)) {
+            return g_Watch.Dirs[I];
+        }
+    }
+
+    if (g_Watch.DirCount == MaxWatchedDirs) {
+        return nullptr;
+    }
+
+    const HANDLE Handle{ CreateFileA(Path, FILE_LIST_DIRECTORY,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr) };
+    if (Handle == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+
+    WatchedDir* Dir{ (WatchedDir*)MemAlloc(sizeof(WatchedDir), MemTag::Core) };
+    const HANDLE Event{ CreateEventA(nullptr, TRUE, FALSE, nullptr) };
+    if (!Dir || !Event) {
+        MemFree(Dir, MemTag::Core);
+        if (Event) {
+            CloseHandle(Event);
+        }
+        CloseHandle(Handle);
+        return nullptr;
+    }
+
+    strcpy_s(Dir->Path, Path);
+    Dir->Handle = Handle;
+    Dir->Event = Event;
+    Dir->Overlapped = {};
+    Dir->Users = 0;
+    Dir->Armed = false;
+
+    g_Watch.Dirs[g_Watch.DirCount++] = Dir;
+    return Dir;
+}
+} // anonymous namespace
+
+u32
+WatchFile(const char* File, FileWatchCallback Callback, void* UserData) {
+    if (!File || !Callback) {
+        return 0;
+    }
+
+    WatchedFile Watch{};
+    char* Name{ nullptr };
+    const DWORD Length{ GetFullPathNameA(File, sizeof(Watch.Path), Watch.Path, &Name) };
+    if (!Length || Length >= sizeof(Watch.Path) || !Name) {
+        return 0;
+    }
+
+    char DirPath[IRON_MAX_PATH];
+    const u64 DirLength{ (u64)(Name - Watch.Path) };
+    MemCopy(DirPath, Watch.Path, DirLength);
+    DirPath[DirLength] = 0;
+
+    std::lock_guard Lock{ g_Watch.Lock };
+    if (!g_Watch.Wake) {
+        g_Watch.Wake = CreateEventA(nullptr, FALSE, FALSE, nullptr);
+        if (!g_Watch.Wake) {
+            return 0;
+        }
+    }
+
+    Watch.Dir = OpenDir(DirPath);
+    if (!Watch.Dir) {
+        LOG_ERROR("Can not watch %s", DirPath);
+        return 0;
+    }
+
+    ++Watch.Dir->Users;
+    Watch.Id = g_Watch.NextId++;
+    Watch.NameOffset = (u32)DirLength;
+    Watch.Callback = Callback;
+    Watch.UserData = UserData;
+    g_Watch.Files.PushBack(Watch);
+
+    if (!g_Watch.Thread.joinable()) {
+        g_Watch.Quit.store(false);
+        g_Watch.Thread = std::thread(WatcherMain);
+    }
+    else {
+        SetEvent(g_Watch.Wake);
+    }
+
+    return Watch.Id;
+}
+
+void
+UnwatchFile(u32 Id) {
+    std::lock_guard Lock{ g_Watch.Lock };
+    for (u32 I{ 0 }; I < g_Watch.Files.Size(); ++I) {
+        WatchedFile& File{ g_Watch.Files[I] };
+        if (File.Id != Id) {
+            continue;
+        }
+
+        --File.Dir->Users;
+
+        const u32 Last{ g_Watch.Files.Size() - 1 };
+        if (I != Last) {
+            File = g_Watch.Files[Last];
+        }
+        g_Watch.Files.Resize(Last);
+
+        // The watcher closes directories nobody watches anymore
+        SetEvent(g_Watch.Wake);
+        return;
+    }
+}
+
+void
+DispatchFileChanges() {
+    InlineVector<PendingChange, 8> Pending{};
+    {
+        const u64 Now{ GetTickCount64() };
+        std::lock_guard Lock{ g_Watch.Lock };
+        for (u32 I{ 0 }; I < g_Watch.Files.Size(); ++I) {
+            WatchedFile& File{ g_Watch.Files[I] };
+            if (!File.ChangedAt || Now - File.ChangedAt < SettleMs) {
+                continue;
+            }
+
+            File.ChangedAt = 0;
+
+            PendingChange& Change{ Pending.EmplaceBack() };
+            Change.Callback = File.Callback;
+            Change.UserData = File.UserData;
+            strcpy_s(Change.Path, File.Path);
+        }
+    }
+
+    // Outside the lock so callbacks may watch and unwatch files
+    for (u32 I{ 0 }; I < Pending.Size(); ++I) {
+        Pending[I].Callback(Pending[I].Path, Pending[I].UserData);
+    }
+}
+
+void
+StopFileWatcher() {
+    if (g_Watch.Thread.joinable()) {
+        g_Watch.Quit.store(true, std::memory_order_release);
+        SetEvent(g_Watch.Wake);
+        g_Watch.Thread.join();
+    }
+
+    std::lock_guard Lock{ g_Watch.Lock };
+    for (u32 I{ 0 }; I < g_Watch.DirCount; ++I) {
+        CloseDir(g_Watch.Dirs[I]);
+    }
+
+    g_Watch.DirCount = 0;
+    g_Watch.Files = {};
+
+    if (g_Watch.Wake) {
+        CloseHandle(g_Watch.Wake);
+        g_Watch.Wake = nullptr;
+    }
+}
+}
@@ -0,0 +1,181 @@
+#include <Iron.Core/Core.h>
+
+#include <stdint.h>
+
+namespace Iron {
+namespace {
+FrameArena  g_FrameArena{};
+
+constexpr inline bool
+IsPow2(u64 Value) {
+    return Value && !(Value & (Value - 1));
+}
+} // anonymous namespace
+
+FrameArena::~FrameArena() {
+    Release();
+}
+
+Result::Code
+FrameArena::Initialize(u32 FrameCount, u64 BlockSize) {
+    if (!FrameCount || FrameCount > MaxFrames || !BlockSize) {
+        return Result::EInvalidarg;
+    }
+
+    Release();
+
+    m_BlockSize = BlockSize;
+
+    for (u32 I{ 0 }; I < FrameCount; ++I) {
+        Block* B{ AllocateBlock(BlockSize) };
+        if (!B) {
+            Release();
+            return Result::ENomemory;
+        }
+
+        m_Frames[I].Head = B;
+        m_Frames[I].Current = B;
+        m_Frames[I].Used = 0;
+    }
+
+    m_FrameCount = FrameCount;
+    m_Current = 0;
+    m_FrameNumber = max_u64;
+
+    return Result::Ok;
+}
+
+void
+FrameArena::Release() {
+    for (u32 I{ 0 }; I < MaxFrames; ++I) {
+        Block* B{ m_Frames[I].Head };
+        while (B) {
+            Block* Next{ B->Next };
+            MemFree(B, MemTag::Core);
+            B = Next;
+        }
+
+        m_Frames[I] = {};
+    }
+
+    m_FrameCount = 0;
+    m_Current = 0;
+    m_FrameNumber = 0;
+    m_BlockSize = 0;
+    m_Committed = 0;
+    m_HighWaterMark = 0;
+    m_OverflowBlocks = 0;
+}
+
+void
+FrameArena::BeginFrame(u64 FrameNumber) {
+    if (!m_FrameCount || FrameNumber == m_FrameNumber) {
+        return;
+    }
+
+    m_FrameNumber = FrameNumber;
+    m_Current = (u32)(FrameNumber % (u64)m_FrameCount);
+
+    ResetFrame(m_Frames[m_Current]);
+}
+
+void*
+FrameArena::Allocate(u64 Size, u64 Alignment) {
+    if (!m_FrameCount || !IsPow2(Alignment)) UNLIKELY {
+        return nullptr;
+    }
+
+    Frame& F{ m_Frames[m_Current] };
+    Block* B{ F.Current };
+    if (!B) UNLIKELY {
+        return nullptr;
+    }
+
+    uintptr_t Base{ (uintptr_t)(B + 1) };
+    uintptr_t Start{ Math::AlignUp(Base + (uintptr_t)B->Offset, (uintptr_t)Alignment) };
+    u64 End{ (u64)(Start - Base) + Size };
+
+    if (End > B->Size) UNLIKELY {
+        // Chain an overflow block, it is folded into the head block on the next reset
+        Block* N{ AllocateBlock(Math::Max(m_BlockSize, Size + Alignment)) };
+        if (!N) {
+            LOG_ERROR("Frame arena out of memory, requested %llu bytes", Size);
+            return nullptr;
+        }
+
+        B->Next = N;
+        F.Current = N;
+        ++m_OverflowBlocks;
+
+        B = N;
+        Base = (uintptr_t)(B + 1);
+        Start = Math::AlignUp(Base, (uintptr_t)Alignment);
+        End = (u64)(Start - Base) + Size;
+    }
+
+    F.Used += End - B->Offset;
+    B->Offset = End;
+    m_HighWaterMark = Math::Max(m_HighWaterMark, F.Used);
+
+    return (void*)Start;
+}
+
+FrameArenaStats
+FrameArena::GetStats() const {
+    FrameArenaStats Stats{};
+    Stats.UsedBytes = m_FrameCount ? m_Frames[m_Current].Used : 0;
+    Stats.CommittedBytes = m_Committed;
+    Stats.HighWaterMark = m_HighWaterMark;
+    Stats.OverflowBlocks = m_OverflowBlocks;
+    return Stats;
+}
+
+FrameArena::Block*
+FrameArena::AllocateBlock(u64 Size) {
+    Block* B{ (Block*)MemAlloc(sizeof(Block) + Size, MemTag::Core) };
+    if (!B) {
+        return nullptr;
+    }
+
+    B->Next = nullptr;
+    B->Size = Size;
+    B->Offset = 0;
+
+    m_Committed += Size;
+
+    return B;
+}
+
+void
+FrameArena::ResetFrame(Frame& F) {
+    if (F.Head && F.Head->Next) {
+        // The frame overflowed, replace the chain with one block large enough for it
+        const u64 Size{ Math::Max(m_BlockSize, F.Used) };
+
+        Block* B{ F.Head };
+        while (B) {
+            Block* Next{ B->Next };
+            m_Committed -= B->Size;
+            MemFree(B, MemTag::Core);
+            B = Next;
+        }
+
+        F.Head = AllocateBlock(Size);
+        if (!F.Head) {
+            F.Head = AllocateBlock(m_BlockSize);
+        }
+    }
+
+    F.Current = F.Head;
+    F.Used = 0;
+
+    if (F.Head) {
+        F.Head->Offset = 0;
+    }
+}
+
+FrameArena&
+GetFrameArena() {
+    return g_FrameArena;
+}
+}
@@ -1,9 +1,92 @@
 #include <Iron.Core/Core.h>
 
+#include <Windows.h>
+#include <atomic>
 #include <fstream>
 #include <filesystem>
+#include <stdio.h>
+#include <string.h>
 
 namespace Iron {
+namespace {
+constexpr u32 MaxWriteChunk{ 64 * 1024 * 1024 };
+
+// Makes the temporary files of writers to the same path distinct, also across processes
+std::atomic<u32> g_TempCounter{};
+
+// Directories known to exist. The names are kept, so a hash collision can't skip a directory
+struct KnownDirectories {
+    HashMap<u64, u32>   Offsets{};
+    Vector<char>        Names{};
+
+    bool Contains(const char* Path, u64 Hash) const {
+        const u32* Offset{ Offsets.Find(Hash) };
+        return Offset && !strcmp(Names.Data() + *Offset, Path);
+    }
+
+    void Add(const char* Path, u64 Hash) {
+        const u32 Offset{ Names.Size() };
+        const u32 Length{ (u32)StrLen(Path) + 1 };
+        if (Offset + Length > Names.Capacity()) {
+            Names.Reserve(Math::Max(Offset + Length, Names.Capacity() * 2));
+            if (Offset + Length > Names.Capacity()) {
+                return;
+            }
+        }
+
+        Names.Resize(Offset + Length);
+        MemCopy(Names.Data() + Offset, Path, Length);
+        Offsets.Emplace(Hash, Offset);
+    }
+};
+
+bool
+IsSeparator(char C) {
+    return C == '\\' || C == '/';
+}
+
+// Path is modified while parents are created and restored before returning
+bool
+CreateDirectoryTree(char* Path, KnownDirectories& Known) {
+    const u64 Hash{ Fnv1A(Path) };
+    if (Known.Contains(Path, Hash)) {
+        return true;
+    }
+
+    if (!CreateDirectoryA(Path, nullptr)) {
+        const DWORD Error{ GetLastError() };
+        if (Error == ERROR_PATH_NOT_FOUND) {
+            char* Parent{ nullptr };
+            for (char* C{ Path }; *C; ++C) {
+                if (IsSeparator(*C) && C[1]) {
+                    Parent = C;
+                }
+            }
+
+            // Drive roots and shares can't be created
+            if (!Parent || Parent == Path || Parent[-1] == ':') {
+                return false;
+            }
+
+            const char Separator{ *Parent };
+            *Parent = 0;
+            const bool Created{ CreateDirectoryTree(Path, Known) };
+            *Parent = Separator;
+
+            if (!Created || (!CreateDirectoryA(Path, nullptr) && GetLastError() != ERROR_ALREADY_EXISTS)) {
+                return false;
+            }
+        }
+        else if (Error != ERROR_ALREADY_EXISTS) {
+            return false;
+        }
+    }
+
+    Known.Add(Path, Hash);
+    return true;
+}
+} // anonymous namespace
+
 Result::Code
 WriteFile(const char* file,
     const u8* const data,
@@ -12,21 +95,19 @@ WriteFile(const char* file,
         return Result::ENullptr;
     }
 
-    const std::filesystem::path directory{ std::filesystem::path(file).parent_path() };
-    if (!std::filesystem::exists(directory)) {
-        std::filesystem::create_directories(directory);
+    FileWriter Writer{};
+    Result::Code Res{ Writer.Open(file, FileWriteFlags::CreateDirectories,
+        (u32)Math::Min(length, (u64)FileWriter::DefaultBufferSize)) };
+    if (Result::Fail(Res)) {
+        return Res;
     }
 
-    std::ofstream ofile{ file, std::ios::out | std::ios::binary };
-    ofile.write((char*)data, length);
-    ofile.flush();
-    ofile.close();
-
-    if (!std::filesystem::exists(file)) {
-        return Result::EWritefile;
+    Res = Writer.Write(data, length);
+    if (Result::Fail(Res)) {
+        return Res;
     }
 
-    return Result::Ok;
+    return Writer.Commit();
 }
 
 Result::Code
@@ -62,4 +143,293 @@ ReadFile(const char* file,
 
     return Result::Ok;
 }
+
+Result::Code
+CreateParentDirectories(const char* const* Files,
+    u32 Count) {
+    if (!Files) {
+        return Result::ENullptr;
+    }
+
+    KnownDirectories Known{};
+    for (u32 I{ 0 }; I < Count; ++I) {
+        if (!Files[I]) {
+            continue;
+        }
+
+        char Directory[IRON_MAX_PATH];
+        u64 Length{ 0 };
+        for (u64 C{ 0 }; Files[I][C]; ++C) {
+            if (IsSeparator(Files[I][C])) {
+                Length = C;
+            }
+        }
+
+        if (!Length) {
+            continue;
+        }
+        if (Length >= sizeof(Directory)) {
+            return Result::EInvalidarg;
+        }
+
+        MemCopy(Directory, Files[I], Length);
+        Directory[Length] = 0;
+        if (!CreateDirectoryTree(Directory, Known)) {
+            LOG_ERROR("Failed to create directory %s (%u)", Directory, (u32)GetLastError());
+            return Result::EWritefile;
+        }
+    }
+
+    return Result::Ok;
+}
+
+Result::Code
+FileWriter::Open(const char* Path,
+    u32 Flags,
+    u32 BufferSize) {
+    if (!Path) {
+        return Result::ENullptr;
+    }
+
+    Abort();
+
+    m_Error = Result::Ok;
+    m_SystemError = 0;
+    m_Written = 0;
+    m_Used = 0;
+    m_Flags = Flags;
+
+    const u64 Length{ StrLen(Path) };
+    if (!Length || Length >= IRON_MAX_PATH) {
+        return Result::EInvalidarg;
+    }
+
+    const int TempLength{ snprintf(m_TempPath, sizeof(m_TempPath), "%s.%lu.%u.tmp", Path,
+        GetCurrentProcessId(), g_TempCounter.fetch_add(1, std::memory_order_relaxed)) };
+    if (TempLength < 0 || TempLength >= (int)sizeof(m_TempPath)) {
+        return Result::EInvalidarg;
+    }
+
+    MemCopy(m_Path, Path, Length + 1);
+
+    m_Capacity = Math::Max(BufferSize, 4096u);
+    m_Buffer = (u8*)MemAlloc(m_Capacity, MemTag::Core);
+    if (!m_Buffer) {
+        return Fail(Result::ENomemory);
+    }
+
+    for (u32 Attempt{ 0 }; Attempt < 2; ++Attempt) {
+        const HANDLE File{ CreateFileA(m_TempPath, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr) };
+        if (File != INVALID_HANDLE_VALUE) {
+            m_File = File;
+            return Result::Ok;
+        }
+
+        // Directories are only looked at when they turn out to be missing
+        if (!Attempt && (Flags & FileWriteFlags::CreateDirectories) && GetLastError() == ERROR_PATH_NOT_FOUND) {
+            const char* Files[]{ m_Path };
+            if (Result::Success(CreateParentDirectories(Files, 1))) {
+                continue;
+            }
+        }
+        break;
+    }
+
+    const Result::Code Res{ Fail(Result::EWritefile) };
+    Abort();
+    return Res;
+}
+
+Result::Code
+FileWriter::Write(const void* Data,
+    u64 Size) {
+    if (Result::Fail(m_Error)) {
+        return m_Error;
+    }
+    if (!m_File) {
+        return Result::ENotInitialized;
+    }
+    if (!Data && Size) {
+        return Result::ENullptr;
+    }
+
+    if (m_Used + Size <= m_Capacity) {
+        MemCopy(m_Buffer + m_Used, Data, Size);
+        m_Used += (u32)Size;
+        return Result::Ok;
+    }
+
+    const Result::Code Res{ Flush() };
+    if (Result::Fail(Res)) {
+        return Res;
+    }
+
+    if (Size >= m_Capacity) {
+        return WriteDirect((const u8*)Data, Size);
+    }
+
+    MemCopy(m_Buffer, Data, Size);
+    m_Used = (u32)Size;
+    return Result::Ok;
+}
+
+Result::Code
+FileWriter::Commit() {
+    if (!m_File) {
+        return Result::Fail(m_Error) ? m_Error : Result::ENotInitialized;
+    }
+
+    Flush();
+    if (Result::Success(m_Error) && !(m_Flags & FileWriteFlags::NoFlush) && !FlushFileBuffers(m_File)) {
+        Fail(Result::EWritefile);
+    }
+
+    CloseHandle(m_File);
+    m_File = nullptr;
+
+    if (Result::Success(m_Error)
+        && !MoveFileExA(m_TempPath, m_Path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        Fail(Result::EWritefile);
+    }
+
+    if (Result::Fail(m_Error)) {
+        DeleteFileA(m_TempPath);
+    }
+
+    MemFree(m_Buffer, MemTag::Core);
+    m_Buffer = nullptr;
+    m_Capacity = 0;
+    m_Used = 0;
+    return m_Error;
+}
+
+void
+FileWriter::Abort() {
+    if (m_File) {
+        CloseHandle(m_File);
+        m_File = nullptr;
+        DeleteFileA(m_TempPath);
+    }
+
+    if (m_Buffer) {
+        MemFree(m_Buffer, MemTag::Core);
+        m_Buffer = nullptr;
+    }
+
+    m_Capacity = 0;
+    m_Used = 0;
+}
+
+Result::Code
+FileWriter::Flush() {
+    if (!m_Used) {
+        return Result::Ok;
+    }
+
+    const Result::Code Res{ WriteDirect(m_Buffer, m_Used) };
+    m_Used = 0;
+    return Res;
+}
+
+Result::Code
+FileWriter::WriteDirect(const u8* Data,
+    u64 Size) {
+    while (Size) {
+        const DWORD Chunk{ (DWORD)Math::Min(Size, (u64)MaxWriteChunk) };
+        DWORD Written{ 0 };
+        if (!::WriteFile(m_File, Data, Chunk, &Written, nullptr) || Written != Chunk) {
+            return Fail(Result::EWritefile);
+        }
+
+        Data += Chunk;
+        Size -= Chunk;
+        m_Written += Chunk;
+    }
+
+    return Result::Ok;
+}
+
+Result::Code
+FileWriter::Fail(Result::Code Code) {
+    if (Result::Success(m_Error)) {
+        m_Error = Code;
+        m_SystemError = (u32)GetLastError();
+        LOG_ERROR("Failed to write %s (%u)", m_Path, m_SystemError);
+    }
+    return m_Error;
+}
+
+Result::Code
+MappedFile::Open(const char* File,
+    FileAccess::Pattern Access) {
+    if (!File) {
+        return Result::ENullptr;
+    }
+
+    Close();
+
+    DWORD Flags{ FILE_ATTRIBUTE_NORMAL };
+    if (Access == FileAccess::Sequential) {
+        Flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+    }
+    else if (Access == FileAccess::Random) {
+        Flags |= FILE_FLAG_RANDOM_ACCESS;
+    }
+
+    const HANDLE Handle{ CreateFileA(File, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, Flags, nullptr) };
+    if (Handle == INVALID_HANDLE_VALUE) {
+        return Result::ELoadfile;
+    }
+
+    LARGE_INTEGER Size{};
+    if (!GetFileSizeEx(Handle, &Size) || !Size.QuadPart) {
+        CloseHandle(Handle);
+        return Result::ELoadfile;
+    }
+
+    // The view keeps the mapping and the file open, both handles can go right away
+    const HANDLE Mapping{ CreateFileMappingA(Handle, nullptr, PAGE_READONLY, 0, 0, nullptr) };
+    CloseHandle(Handle);
+    if (!Mapping) {
+        return Result::ELoadfile;
+    }
+
+    const void* View{ MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0) };
+    CloseHandle(Mapping);
+    if (!View) {
+        return Result::ENomemory;
+    }
+
+    m_Data = (const u8*)View;
+    m_Size = (u64)Size.QuadPart;
+
+    if (Access == FileAccess::Sequential) {
+        Prefetch(0, m_Size);
+    }
+
+    return Result::Ok;
+}
+
+void
+MappedFile::Close() {
+    if (m_Data) {
+        UnmapViewOfFile(m_Data);
+        m_Data = nullptr;
+        m_Size = 0;
+    }
+}
+
+void
+MappedFile::Prefetch(u64 Offset,
+    u64 Length) const {
+    if (!m_Data || Offset >= m_Size) {
+        return;
+    }
+
+    WIN32_MEMORY_RANGE_ENTRY Range{};
+    Range.VirtualAddress = (void*)(m_Data + Offset);
+    Range.NumberOfBytes = (SIZE_T)Math::Min(Length, m_Size - Offset);
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &Range, 0);
+}
 }
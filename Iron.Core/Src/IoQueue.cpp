@@ -0,0 +1,569 @@
+#include <Iron.Core/Core.h>
+
+#include <Windows.h>
+#include <mutex>
+#include <thread>
+
+namespace Iron {
+namespace {
+constexpr u32 MaxReadsInFlight{ 32 };
+constexpr u32 ChunkSize{ 1024 * 1024 };
+constexpr u32 MaxOpenFiles{ 32 };
+constexpr ULONG_PTR WakeKey{ 1 };
+constexpr ULONG_PTR ReadKey{ 2 };
+
+struct OpenFile {
+    char        Path[IRON_MAX_PATH];
+    HANDLE      Handle;
+    u32         Users;
+};
+
+// Only the IO thread writes the fields below Cancelled, Linked only under the lock
+struct Request {
+    u64                     Id;
+    char                    Path[IRON_MAX_PATH];
+    u64                     Offset;
+    u64                     Size;
+    u8*                     Buffer;
+    IoCallback              Callback;
+    void*                   UserData;
+    IoPriority::Priority    Priority;
+    Request*                Next;
+    bool                    Cancelled;
+
+    OpenFile*               File;
+    u64                     Issued;
+    u64                     Done;
+    u32                     Reading;
+    bool                    Owned;      // Buffer was allocated by the queue
+    bool                    Failed;
+    bool                    Linked;     // Still in its priority list, more chunks will be issued
+};
+
+struct Read {
+    OVERLAPPED  Overlapped;
+    Request*    Owner;      // Null while the slot is free
+    u32         Length;
+};
+
+struct RequestList {
+    Request*    Head;
+    Request*    Tail;
+};
+
+struct IoQueue {
+    std::mutex              Lock;
+    std::thread             Thread;
+    HANDLE                  Port{};
+    bool                    Quit{};
+    bool                    CancelPending{};
+    RequestList             Lists[IoPriority::Count]{};
+    HashMap<u64, Request*>  Active{};
+    Request*                FreeList{};
+    u64                     NextId{ 1 };
+    u64                     Budget{ 0 };
+    u64                     Spent{ 0 };
+
+    // IO thread only
+    Read                    Reads[MaxReadsInFlight]{};
+    u32                     InFlight{ 0 };
+    OpenFile                Files[MaxOpenFiles]{};
+};
+
+IoQueue g_Io{};
+
+// Lock held
+void
+Link(Request* R) {
+    RequestList& List{ g_Io.Lists[R->Priority] };
+    R->Next = nullptr;
+    R->Linked = true;
+    if (List.Tail) {
+        List.Tail->Next = R;
+    }
+    else {
+        List.Head = R;
+    }
+    List.Tail = R;
+}
+
+// Lock held
+void
+Unlink(Request* R) {
+    RequestList& List{ g_Io.Lists[R->Priority] };
+    Request* Prev{ nullptr };
+    for (Request* It{ List.Head }; It; Prev = It, It = It->Next) {
+        if (It != R) {
+            continue;
+        }
+
+        if (Prev) {
+            Prev->Next = R->Next;
+        }
+        else {
+            List.Head = R->Next;
+        }
+        if (List.Tail == R) {
+            List.Tail = Prev;
+        }
+        break;
+    }
+
+    R->Next = nullptr;
+    R->Linked = false;
+}
+
+// Lock held, the first request of the highest priority list the budget allows. Cancelled
+// requests stay linked until ProcessCancels removes them, they get no further chunks.
+Request*
+Pick() {
+    if (g_Io.Quit) {
+        return nullptr;
+    }
+
+    for (u32 P{ 0 }; P < IoPriority::Count; ++P) {
+        if (P != IoPriority::Critical && g_Io.Budget && g_Io.Spent >= g_Io.Budget) {
+            return nullptr;
+        }
+        for (Request* R{ g_Io.Lists[P].Head }; R; R = R->Next) {
+            if (!R->Cancelled) {
+                return R;
+            }
+        }
+    }
+    return nullptr;
+}
+
+OpenFile*
+AcquireFile(const char* Path) {
+    OpenFile* Free{ nullptr };
+    for (u32 I{ 0 }; I < MaxOpenFiles; ++I) {
+        OpenFile& File{ g_Io.Files[I] };
+        if (File.Handle && !_stricmp(File.Path, Path)) {
+            ++File.Users;
+            return &File;
+        }
+        if (!Free && (!File.Handle || !File.Users)) {
+            Free = &File;
+        }
+    }
+
+    if (!Free) {
+        return nullptr;
+    }
+
+    if (Free->Handle) {
+        CloseHandle(Free->Handle);
+        Free->Handle = nullptr;
+    }
+
+    // Shared for writing so editors and hot reload can still save the file
+    const HANDLE Handle{ CreateFileA(Path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr) };
+    if (Handle == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+
+    if (!CreateIoCompletionPort(Handle, g_Io.Port, ReadKey, 0)) {
+        CloseHandle(Handle);
+        return nullptr;
+    }
+
+    strcpy_s(Free->Path, Path);
+    Free->Handle = Handle;
+    Free->Users = 1;
+    return Free;
+}
+
+// Idle handles would keep serving the old file after an atomic replace
+void
+CloseIdleFiles() {
+    for (u32 I{ 0 }; I < MaxOpenFiles; ++I) {
+        OpenFile& File{ g_Io.Files[I] };
+        if (File.Handle && !File.Users) {
+            CloseHandle(File.Handle);
+            File.Handle = nullptr;
+        }
+    }
+}
+
+void
+Finish(Request* R, Result::Code Code) {
+    {
+        std::lock_guard Lock{ g_Io.Lock };
+        g_Io.Active.Erase(R->Id);
+        if (R->Cancelled) {
+            Code = Result::ECancelled;
+        }
+    }
+
+    if (R->File) {
+        --R->File->Users;
+    }
+
+    if (Result::Fail(Code) && R->Owned) {
+        MemFree(R->Buffer);
+        R->Buffer = nullptr;
+    }
+
+    R->Callback({ Code, R->Buffer, Result::Fail(Code) ? 0 : R->Done, R->UserData });
+
+    std::lock_guard Lock{ g_Io.Lock };
+    R->Next = g_Io.FreeList;
+    g_Io.FreeList = R;
+}
+
+void
+Fail(Request* R, Result::Code Code) {
+    {
+        std::lock_guard Lock{ g_Io.Lock };
+        Unlink(R);
+    }
+
+    R->Failed = true;
+    if (!R->Reading) {
+        Finish(R, Code);
+    }
+}
+
+// Opens the file and sizes the request before its first chunk, false if it failed
+bool
+Prepare(Request* R) {
+    R->File = AcquireFile(R->Path);
+    if (!R->File) {
+        Fail(R, Result::ELoadfile);
+        return false;
+    }
+
+    LARGE_INTEGER FileSize{};
+    if (!GetFileSizeEx(R->File->Handle, &FileSize) || R->Offset >= (u64)FileSize.QuadPart) {
+        Fail(R, Result::ELoadfile);
+        return false;
+    }
+
+    const u64 Available{ (u64)FileSize.QuadPart - R->Offset };
+    if (!R->Size) {
+        R->Size = Available;
+    }
+    else if (R->Size > Available) {
+        Fail(R, Result::ELoadfile);
+        return false;
+    }
+
+    if (!R->Buffer) {
+        R->Buffer = (u8*)MemAlloc(R->Size);
+        R->Owned = true;
+        if (!R->Buffer) {
+            Fail(R, Result::ENomemory);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void
+Issue() {
+    while (g_Io.InFlight < MaxReadsInFlight) {
+        Request* R{ nullptr };
+        {
+            std::lock_guard Lock{ g_Io.Lock };
+            R = Pick();
+        }
+
+        if (!R) {
+            return;
+        }
+
+        if (!R->File && !Prepare(R)) {
+            continue;
+        }
+
+        Read* Slot{ nullptr };
+        for (u32 I{ 0 }; I < MaxReadsInFlight; ++I) {
+            if (!g_Io.Reads[I].Owner) {
+                Slot = &g_Io.Reads[I];
+                break;
+            }
+        }
+
+        const u64 Position{ R->Offset + R->Issued };
+        Slot->Overlapped = {};
+        Slot->Overlapped.Offset = (DWORD)Position;
+        Slot->Overlapped.OffsetHigh = (DWORD)(Position >> 32);
+        Slot->Length = (u32)Math::Min((u64)ChunkSize, R->Size - R->Issued);
+
+        if (!::ReadFile(R->File->Handle, R->Buffer + R->Issued, Slot->Length, nullptr, &Slot->Overlapped)
+            && GetLastError() != ERROR_IO_PENDING) {
+            Fail(R, Result::ELoadfile);
+            continue;
+        }
+
+        // Completes through the port even when ReadFile finished synchronously
+        Slot->Owner = R;
+        ++R->Reading;
+        ++g_Io.InFlight;
+        R->Issued += Slot->Length;
+
+        std::lock_guard Lock{ g_Io.Lock };
+        // Critical reads ignore the budget, so they don't use it up either
+        if (R->Priority != IoPriority::Critical) {
+            g_Io.Spent += Slot->Length;
+        }
+        if (R->Issued == R->Size) {
+            Unlink(R);
+        }
+    }
+}
+
+void
+Complete(Read* Slot) {
+    Request* R{ Slot->Owner };
+    DWORD Bytes{ 0 };
+    const bool Done{ GetOverlappedResult(R->File->Handle, &Slot->Overlapped, &Bytes, FALSE) != 0 };
+
+    Slot->Owner = nullptr;
+    --g_Io.InFlight;
+    --R->Reading;
+    R->Done += Bytes;
+
+    if (!Done || Bytes != Slot->Length) {
+        if (R->Linked) {
+            std::lock_guard Lock{ g_Io.Lock };
+            Unlink(R);
+        }
+        R->Failed = true;
+    }
+
+    if (!R->Reading && !R->Linked) {
+        Finish(R, R->Failed ? Result::ELoadfile : Result::Ok);
+    }
+}
+
+void
+ProcessCancels() {
+    InlineVector<Request*, 16> Cancelled{};
+    {
+        std::lock_guard Lock{ g_Io.Lock };
+        if (!g_Io.CancelPending && !g_Io.Quit) {
+            return;
+        }
+        g_Io.CancelPending = false;
+
+        for (u32 P{ 0 }; P < IoPriority::Count; ++P) {
+            for (Request* R{ g_Io.Lists[P].Head }; R;) {
+                Request* Next{ R->Next };
+                R->Cancelled |= g_Io.Quit;
+                if (R->Cancelled) {
+                    Unlink(R);
+                    if (!R->Reading) {
+                        Cancelled.PushBack(R);
+                    }
+                }
+                R = Next;
+            }
+        }
+
+        for (u32 I{ 0 }; I < MaxReadsInFlight; ++I) {
+            Read& Slot{ g_Io.Reads[I] };
+            if (Slot.Owner && (Slot.Owner->Cancelled || g_Io.Quit)) {
+                Slot.Owner->Cancelled = true;
+                CancelIoEx(Slot.Owner->File->Handle, &Slot.Overlapped);
+            }
+        }
+    }
+
+    for (u32 I{ 0 }; I < Cancelled.Size(); ++I) {
+        Finish(Cancelled[I], Result::ECancelled);
+    }
+}
+
+void
+IoMain() {
+    SetCurrentThreadName("Iron IO");
+
+    OVERLAPPED_ENTRY Entries[MaxReadsInFlight];
+
+    for (;;) {
+        ProcessCancels();
+        Issue();
+
+        bool Quit{ false };
+        bool Idle{ true };
+        {
+            std::lock_guard Lock{ g_Io.Lock };
+            Quit = g_Io.Quit;
+            for (u32 P{ 0 }; P < IoPriority::Count; ++P) {
+                Idle &= !g_Io.Lists[P].Head;
+            }
+        }
+
+        if (!g_Io.InFlight) {
+            if (Quit) {
+                break;
+            }
+            if (Idle) {
+                CloseIdleFiles();
+            }
+        }
+
+        ULONG Count{ 0 };
+        if (!GetQueuedCompletionStatusEx(g_Io.Port, Entries, MaxReadsInFlight, &Count, INFINITE, FALSE)) {
+            continue;
+        }
+
+        for (ULONG I{ 0 }; I < Count; ++I) {
+            if (Entries[I].lpCompletionKey == ReadKey) {
+                Complete((Read*)Entries[I].lpOverlapped);
+            }
+        }
+    }
+}
+
+bool
+IsValid(const IoReadInfo& Info) {
+    return Info.Path && Info.Callback && Info.Priority < IoPriority::Count
+        && (!Info.Buffer || Info.Size) && StrLen(Info.Path) < IRON_MAX_PATH;
+}
+} // anonymous namespace
+
+Result::Code
+StartIoQueue() {
+    if (g_Io.Thread.joinable()) {
+        return Result::Ok;
+    }
+
+    g_Io.Port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+    if (!g_Io.Port) {
+        return Result::ENotInitialized;
+    }
+
+    g_Io.Quit = false;
+    g_Io.Thread = std::thread(IoMain);
+    return Result::Ok;
+}
+
+void
+StopIoQueue() {
+    if (!g_Io.Thread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard Lock{ g_Io.Lock };
+        g_Io.Quit = true;
+    }
+
+    PostQueuedCompletionStatus(g_Io.Port, 0, WakeKey, nullptr);
+    g_Io.Thread.join();
+
+    CloseIdleFiles();
+    CloseHandle(g_Io.Port);
+    g_Io.Port = nullptr;
+
+    std::lock_guard Lock{ g_Io.Lock };
+    while (g_Io.FreeList) {
+        Request* Next{ g_Io.FreeList->Next };
+        MemFree(g_Io.FreeList, MemTag::Core);
+        g_Io.FreeList = Next;
+    }
+    g_Io.Active = {};
+}
+
+u64
+SubmitRead(const IoReadInfo& Info) {
+    u64 Id{ 0 };
+    SubmitReads(&Info, 1, &Id);
+    return Id;
+}
+
+void
+SubmitReads(const IoReadInfo* Infos, u32 Count, u64* Ids) {
+    if (!Infos) {
+        return;
+    }
+
+    HANDLE Port{ nullptr };
+    {
+        std::lock_guard Lock{ g_Io.Lock };
+        for (u32 I{ 0 }; I < Count; ++I) {
+            if (Ids) {
+                Ids[I] = 0;
+            }
+
+            const IoReadInfo& Info{ Infos[I] };
+            if (!g_Io.Port || g_Io.Quit || !IsValid(Info)) {
+                continue;
+            }
+
+            Request* R{ g_Io.FreeList };
+            if (R) {
+                g_Io.FreeList = R->Next;
+            }
+            else {
+                R = (Request*)MemAlloc(sizeof(Request), MemTag::Core);
+                if (!R) {
+                    continue;
+                }
+            }
+
+            *R = {};
+            R->Id = g_Io.NextId++;
+            strcpy_s(R->Path, Info.Path);
+            R->Offset = Info.Offset;
+            R->Size = Info.Size;
+            R->Buffer = Info.Buffer;
+            R->Callback = Info.Callback;
+            R->UserData = Info.UserData;
+            R->Priority = Info.Priority;
+
+            g_Io.Active.Emplace(R->Id, R);
+            Link(R);
+
+            if (Ids) {
+                Ids[I] = R->Id;
+            }
+            Port = g_Io.Port;
+        }
+    }
+
+    if (Port) {
+        PostQueuedCompletionStatus(Port, 0, WakeKey, nullptr);
+    }
+}
+
+bool
+CancelRead(u64 Id) {
+    HANDLE Port{ nullptr };
+    {
+        std::lock_guard Lock{ g_Io.Lock };
+        Request* const* Found{ g_Io.Active.Find(Id) };
+        if (!Found || (*Found)->Cancelled) {
+            return false;
+        }
+
+        (*Found)->Cancelled = true;
+        g_Io.CancelPending = true;
+        Port = g_Io.Port;
+    }
+
+    PostQueuedCompletionStatus(Port, 0, WakeKey, nullptr);
+    return true;
+}
+
+void
+BeginIoFrame(u64 BudgetBytes) {
+    HANDLE Port{ nullptr };
+    {
+        std::lock_guard Lock{ g_Io.Lock };
+        // Reads held back by the budget can go now
+        Port = g_Io.Spent && g_Io.Budget && g_Io.Spent >= g_Io.Budget ? g_Io.Port : nullptr;
+        g_Io.Budget = BudgetBytes;
+        g_Io.Spent = 0;
+    }
+
+    if (Port) {
+        PostQueuedCompletionStatus(Port, 0, WakeKey, nullptr);
+    }
+}
+}
@@ -0,0 +1,384 @@
+#include <Iron.Core/Concurrent.h>
+
+#include <Windows.h>
+#include <condition_variable>
+#include <mutex>
+#include <stdio.h>
+#include <thread>
+
+namespace Iron {
+namespace {
+constexpr u32 DequeCapacity{ 4096 };
+constexpr u32 InjectCapacity{ 4096 };
+constexpr u32 SpinCount{ 256 };
+
+struct Job {
+    JobFunc         Func;
+    void*           Data;
+    JobCounter*     Counter;
+};
+
+// Chase-Lev work stealing deque with a fixed capacity. The owner pushes and pops at the
+// bottom, other threads steal from the top. Slot fields are relaxed atomics, a thief that
+// reads a slot being overwritten always loses the CAS on Top and discards what it read.
+class StealDeque {
+public:
+    bool Push(const Job& J) {
+        const s64 Bottom{ m_Bottom.load(std::memory_order_relaxed) };
+        const s64 Top{ m_Top.load(std::memory_order_acquire) };
+        if (Bottom - Top >= (s64)DequeCapacity) {
+            return false;
+        }
+
+        Write(Bottom, J);
+        m_Bottom.store(Bottom + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Pop(Job& Out) {
+        const s64 Bottom{ m_Bottom.load(std::memory_order_relaxed) - 1 };
+        m_Bottom.store(Bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        s64 Top{ m_Top.load(std::memory_order_relaxed) };
+
+        if (Top > Bottom) {
+            m_Bottom.store(Bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        Read(Bottom, Out);
+        if (Top == Bottom) {
+            // Last job, race the thieves for it
+            const bool Won{ m_Top.compare_exchange_strong(Top, Top + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed) };
+            m_Bottom.store(Bottom + 1, std::memory_order_relaxed);
+            return Won;
+        }
+
+        return true;
+    }
+
+    bool Steal(Job& Out) {
+        s64 Top{ m_Top.load(std::memory_order_acquire) };
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const s64 Bottom{ m_Bottom.load(std::memory_order_acquire) };
+
+        if (Top >= Bottom) {
+            return false;
+        }
+
+        Read(Top, Out);
+        return m_Top.compare_exchange_strong(Top, Top + 1,
+            std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot {
+        std::atomic<JobFunc>        Func;
+        std::atomic<void*>          Data;
+        std::atomic<JobCounter*>    Counter;
+    };
+
+    alignas(CacheLineSize) std::atomic<s64> m_Top{};
+    alignas(CacheLineSize) std::atomic<s64> m_Bottom{};
+    alignas(CacheLineSize) Slot             m_Slots[DequeCapacity]{};
+
+    void Write(s64 Index, const Job& J) {
+        Slot& S{ m_Slots[Index & (DequeCapacity - 1)] };
+        S.Func.store(J.Func, std::memory_order_relaxed);
+        S.Data.store(J.Data, std::memory_order_relaxed);
+        S.Counter.store(J.Counter, std::memory_order_relaxed);
+    }
+
+    void Read(s64 Index, Job& Out) const {
+        const Slot& S{ m_Slots[Index & (DequeCapacity - 1)] };
+        Out.Func = S.Func.load(std::memory_order_relaxed);
+        Out.Data = S.Data.load(std::memory_order_relaxed);
+        Out.Counter = S.Counter.load(std::memory_order_relaxed);
+    }
+};
+
+struct JobThread {
+    StealDeque      Deques[JobPriority::Count];
+    std::thread     Thread;
+    u32             Seed;
+};
+
+struct JobSystem {
+    JobThread*              Threads{};
+    u32                     ThreadCount{};
+    MpmcQueue<Job>          Inject[JobPriority::Count];
+
+    // Jobs pushed but not yet taken, workers only sleep while it is zero
+    alignas(CacheLineSize) std::atomic<s32> Queued{};
+    alignas(CacheLineSize) std::atomic<u32> Sleeping{};
+    std::atomic<bool>       Quit{};
+    std::mutex              Lock;
+    std::condition_variable Wake;
+};
+
+JobSystem   g_Jobs{};
+thread_local u32 t_JobThreadIndex{ max_u32 };
+
+inline void
+Execute(const Job& J) {
+    J.Func(J.Data);
+    if (J.Counter) {
+        J.Counter->Value.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+// Own deque first, then jobs queued from outside, then a random victim.
+// Higher priorities are drained everywhere before lower ones are looked at.
+bool
+TryGetJob(Job& Out) {
+    const u32 Self{ t_JobThreadIndex };
+    const u32 Count{ g_Jobs.ThreadCount };
+    if (!Count) {
+        return false;
+    }
+
+    for (u32 P{ 0 }; P < JobPriority::Count; ++P) {
+        if (Self < Count && g_Jobs.Threads[Self].Deques[P].Pop(Out)) {
+            g_Jobs.Queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        if (g_Jobs.Inject[P].TryPop(Out)) {
+            g_Jobs.Queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        u32 Victim{ 0 };
+        if (Self < Count) {
+            // xorshift, good enough to spread thieves over victims
+            u32& Seed{ g_Jobs.Threads[Self].Seed };
+            Seed ^= Seed << 13;
+            Seed ^= Seed >> 17;
+            Seed ^= Seed << 5;
+            Victim = Seed;
+        }
+
+        for (u32 I{ 0 }; I < Count; ++I) {
+            const u32 Index{ (Victim + I) % Count };
+            if (Index != Self && g_Jobs.Threads[Index].Deques[P].Steal(Out)) {
+                g_Jobs.Queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void
+WorkerMain(u32 Index) {
+    t_JobThreadIndex = Index;
+
+    char Name[32];
+    snprintf(Name, sizeof(Name), "Iron Worker %u", Index);
+    SetCurrentThreadName(Name);
+
+    // Core 0 is left to the thread that started the job system. That thread isn't pinned, so
+    // the OS can still move it off core 0 while interrupts are handled there. Workers past the
+    // physical core count float.
+    if (Index < GetCpuTopology().PhysicalCores) {
+        PinCurrentThreadToCore(Index);
+    }
+
+    u32 Idle{ 0 };
+    while (!g_Jobs.Quit.load(std::memory_order_acquire)) {
+        Job J;
+        if (TryGetJob(J)) {
+            Execute(J);
+            Idle = 0;
+            continue;
+        }
+
+        if (++Idle < SpinCount) {
+            YieldProcessor();
+            continue;
+        }
+
+        std::unique_lock Lock{ g_Jobs.Lock };
+        g_Jobs.Sleeping.fetch_add(1);
+        g_Jobs.Wake.wait(Lock, [] {
+            return g_Jobs.Queued.load() > 0 || g_Jobs.Quit.load();
+        });
+        g_Jobs.Sleeping.fetch_sub(1);
+        Idle = 0;
+    }
+}
+
+void
+ReleaseInjectQueues() {
+    for (u32 P{ 0 }; P < JobPriority::Count; ++P) {
+        g_Jobs.Inject[P].Release();
+    }
+}
+
+void
+WakeWorkers(u32 Count) {
+    // Pairs with the Sleeping increment and Queued check made under the lock by a worker
+    if (!g_Jobs.Sleeping.load()) {
+        return;
+    }
+
+    std::lock_guard Lock{ g_Jobs.Lock };
+    if (Count == 1) {
+        g_Jobs.Wake.notify_one();
+    }
+    else {
+        g_Jobs.Wake.notify_all();
+    }
+}
+} // anonymous namespace
+
+Result::Code
+InitializeJobSystem(u32 WorkerCount) {
+    if (g_Jobs.ThreadCount) {
+        return Result::Ok;
+    }
+
+    if (!WorkerCount) {
+        // One worker per physical core besides the main thread, SMT siblings only
+        // compete with the worker already running on their core
+        const u32 Cores{ GetCpuTopology().PhysicalCores };
+        WorkerCount = Cores > 1 ? Cores - 1 : 1;
+    }
+
+    for (u32 P{ 0 }; P < JobPriority::Count; ++P) {
+        const Result::Code Res{ g_Jobs.Inject[P].Initialize(InjectCapacity) };
+        if (Result::Fail(Res)) {
+            ReleaseInjectQueues();
+            return Res;
+        }
+    }
+
+    const u32 Count{ WorkerCount + 1 };
+    g_Jobs.Threads = (JobThread*)HeapAllocator::Allocate<alignof(JobThread)>(sizeof(JobThread) * Count);
+    if (!g_Jobs.Threads) {
+        ReleaseInjectQueues();
+        return Result::ENomemory;
+    }
+
+    for (u32 I{ 0 }; I < Count; ++I) {
+        new (&g_Jobs.Threads[I]) JobThread{};
+        g_Jobs.Threads[I].Seed = 0x9E3779B9u * (I + 1);
+    }
+
+    g_Jobs.Quit.store(false);
+    g_Jobs.Queued.store(0);
+    g_Jobs.ThreadCount = Count;
+    t_JobThreadIndex = 0;
+
+    for (u32 I{ 1 }; I < Count; ++I) {
+        g_Jobs.Threads[I].Thread = std::thread(WorkerMain, I);
+    }
+
+    LOG_INFO("Job system started with %u workers", WorkerCount);
+
+    return Result::Ok;
+}
+
+void
+ShutdownJobSystem() {
+    if (!g_Jobs.ThreadCount) {
+        return;
+    }
+
+    {
+        std::lock_guard Lock{ g_Jobs.Lock };
+        g_Jobs.Quit.store(true);
+    }
+    g_Jobs.Wake.notify_all();
+
+    for (u32 I{ 1 }; I < g_Jobs.ThreadCount; ++I) {
+        g_Jobs.Threads[I].Thread.join();
+    }
+
+    // Nothing can steal anymore, run whatever is left so counters still reach zero
+    t_JobThreadIndex = 0;
+
+    Job J;
+    while (TryGetJob(J)) {
+        Execute(J);
+    }
+
+    t_JobThreadIndex = max_u32;
+
+    for (u32 I{ 0 }; I < g_Jobs.ThreadCount; ++I) {
+        g_Jobs.Threads[I].~JobThread();
+    }
+
+    HeapAllocator::Free<alignof(JobThread)>(g_Jobs.Threads);
+    g_Jobs.Threads = nullptr;
+    g_Jobs.ThreadCount = 0;
+
+    ReleaseInjectQueues();
+}
+
+u32
+GetJobThreadCount() {
+    return g_Jobs.ThreadCount ? g_Jobs.ThreadCount : 1;
+}
+
+u32
+GetJobThreadIndex() {
+    return t_JobThreadIndex;
+}
+
+void
+RunJobs(const JobDecl* Jobs, u32 Count, JobCounter* Counter, JobPriority::Priority Priority) {
+    if (!Jobs || !Count) {
+        return;
+    }
+
+    if (Counter) {
+        Counter->Value.fetch_add(Count, std::memory_order_relaxed);
+    }
+
+    const u32 Self{ t_JobThreadIndex };
+    u32 Pushed{ 0 };
+
+    for (u32 I{ 0 }; I < Count; ++I) {
+        const Job J{ Jobs[I].Func, Jobs[I].Data, Counter };
+
+        bool Queued{ false };
+        if (g_Jobs.ThreadCount) {
+            Queued = Self < g_Jobs.ThreadCount
+                ? g_Jobs.Threads[Self].Deques[Priority].Push(J)
+                : g_Jobs.Inject[Priority].TryPush(J);
+        }
+
+        if (!Queued) {
+            Execute(J);
+            continue;
+        }
+
+        g_Jobs.Queued.fetch_add(1);
+        ++Pushed;
+    }
+
+    if (Pushed) {
+        WakeWorkers(Pushed);
+    }
+}
+
+void
+WaitForCounter(JobCounter* Counter) {
+    if (!Counter) {
+        return;
+    }
+
+    while (!Counter->IsDone()) {
+        Job J;
+        if (TryGetJob(J)) {
+            Execute(J);
+        }
+        else {
+            YieldProcessor();
+        }
+    }
+}
+}
@@ -1,14 +1,86 @@
-#include <Iron.Core/Core.h>
+#include <Iron.Core/Concurrent.h>
 
+#include <Windows.h>
+#include <chrono>
+#include <condition_variable>
 #include <mutex>
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
+#include <thread>
 
 namespace Iron {
 namespace {
-bool        g_EnabledLevels[LogLevel::Count]{};
-bool        g_IncludeFile{ true };
-std::mutex  g_LogMutex{};
+constexpr u32 LogQueueCapacity{ 1024 };
+constexpr u32 LogLineSize{ 1024 - 16 };
+constexpr u32 MaxLogSinks{ 8 };
+constexpr u32 SinkFlushIntervalMs{ 250 };
+
+// A fully formatted line, the producer does the formatting so the writer only copies
+struct LogRecord {
+    LogLevel::Level Level;
+    u16             Length;
+    bool            KeptOnly;   // Logged while a binary log was open, see SinkEntry::Flags
+    u64             Time;
+    char            Text[LogLineSize];
+};
+
+struct SinkEntry {
+    ILogSink*       Sink;
+    LogLevel::Level MinLevel;
+    u32             Flags;
+};
+
+using LogQueue = MpmcQueue<LogRecord, TaggedAllocator<MemTag::Static>>;
+
+struct LogWriter {
+    LogQueue                Queue;
+    std::thread             Thread;
+    std::atomic<bool>       Running{};
+    std::atomic<bool>       Quit{};
+
+    alignas(CacheLineSize) std::atomic<u64> Pushed{};
+    alignas(CacheLineSize) std::atomic<u64> Written{};
+    // FlushLog bumps Requested and waits until the writer has flushed every sink up to it
+    std::atomic<u64>        FlushRequested{};
+    std::atomic<u64>        FlushDone{};
+    std::atomic<bool>       Sleeping{};
+    std::mutex              Lock;
+    std::condition_variable Wake;
+
+    // Held while sinks are called, by the writer thread or by a synchronous Log
+    std::mutex              OutputLock;
+    SinkEntry               Sinks[MaxLogSinks]{};
+    u32                     SinkCount{};
+    // Lowest MinLevel of the sinks kept with a binary log, Count while there is none
+    std::atomic<u32>        KeptLevel{ LogLevel::Count };
+};
+
+constexpr u64 BinaryLogClosed{ max_u64 >> 1 };
+
+struct BinaryLogFile {
+    HANDLE                  File{ INVALID_HANDLE_VALUE };
+    HANDLE                  Mapping{};
+    u8*                     Base{};
+    u64                     Capacity{};
+    u32                     NextSite{};
+    std::atomic<u32>        Generation{};   // Bumped by every open, site ids are only valid within one
+    std::atomic<bool>       Open{};
+    std::atomic<u64>        Dropped{};      // Records that did not fit, copied to the header
+    std::mutex              Lock;
+
+    // Next free byte, every event reserves its record with a single fetch_add.
+    // Holds BinaryLogClosed while no file is mapped so reservations fail.
+    alignas(CacheLineSize) std::atomic<u64> Offset{ BinaryLogClosed };
+    // Bytes of finished records, CloseBinaryLog waits for it to reach Offset
+    alignas(CacheLineSize) std::atomic<u64> Committed{};
+};
+
+std::atomic<bool>   g_EnabledLevels[LogLevel::Count]{};
+std::atomic<bool>   g_IncludeFile{ true };
+LogWriter           g_Log{};
+BinaryLogFile       g_Binary{};
+thread_local u32    t_ThreadId{};
 
 constexpr static const char* g_Errors[Result::Count]{
     "Ok",
@@ -31,60 +103,619 @@ constexpr static const char* g_Errors[Result::Count]{
     "EFrameGraph",
     "EShaderError",
     "EInvalidData",
+    "ECancelled",
 };
 
-} // anonymous namespace
+// Used while no sink is registered, so early messages still reach the console
+void
+WriteConsoleFallback(const LogMessage& Message) {
+    constexpr static const char* LevelText[]{
+        "\x1b[36m[DEBUG]\x1b[0m ",
+        "\x1b[37m[INFO]\x1b[0m ",
+        "\x1b[33m[WARNING]\x1b[0m ",
+        "\x1b[31m[ERROR]\x1b[0m ",
+        "\x1b[34m[FATAL]\x1b[0m "
+    };
 
+    static_assert(_countof(LevelText) == LogLevel::Count, "Level text array size mismatch");
+
+    fputs(LevelText[Message.Level], stdout);
+    fwrite(Message.Text, 1, Message.Length, stdout);
+}
 
+// OutputLock must be held, KeptOnly messages only go to sinks kept with a binary log
 void
-Log(LogLevel::Level Level, const char* File, int Line, const char* Msg, ...) {
-    std::lock_guard Lock{ g_LogMutex };
+Dispatch(const LogMessage& Message, bool KeptOnly) {
+    if (!g_Log.SinkCount) {
+        if (!KeptOnly) {
+            WriteConsoleFallback(Message);
+        }
+        return;
+    }
+
+    for (u32 I{ 0 }; I < g_Log.SinkCount; ++I) {
+        const SinkEntry& Entry{ g_Log.Sinks[I] };
+        if (Message.Level >= Entry.MinLevel
+            && (!KeptOnly || (Entry.Flags & LogSinkFlags::KeepWithBinaryLog))) {
+            Entry.Sink->Write(Message);
+        }
+    }
+}
+
+// OutputLock must be held
+void
+UpdateKeptLevel() {
+    u32 Level{ LogLevel::Count };
+    for (u32 I{ 0 }; I < g_Log.SinkCount; ++I) {
+        if (g_Log.Sinks[I].Flags & LogSinkFlags::KeepWithBinaryLog) {
+            Level = Math::Min(Level, (u32)g_Log.Sinks[I].MinLevel);
+        }
+    }
+
+    g_Log.KeptLevel.store(Level, std::memory_order_relaxed);
+}
+
+// OutputLock must be held, returns true while a sink still buffers data
+bool
+FlushSinks(bool Force) {
+    if (!g_Log.SinkCount) {
+        fflush(stdout);
+        return false;
+    }
+
+    bool Pending{ false };
+    for (u32 I{ 0 }; I < g_Log.SinkCount; ++I) {
+        Pending |= g_Log.Sinks[I].Sink->Flush(Force);
+    }
+
+    return Pending;
+}
+
+void
+WriteNow(const LogMessage& Message, bool KeptOnly) {
+    std::lock_guard Lock{ g_Log.OutputLock };
+    Dispatch(Message, KeptOnly);
+    FlushSinks(Message.Level >= LogLevel::Error);
+}
+
+// Drains everything queued so far, returns the number of records written
+u32
+WriteBatch() {
+    u32 Records{ 0 };
+
+    LogRecord Record;
+    if (!g_Log.Queue.TryPop(Record)) {
+        return 0;
+    }
+
+    std::lock_guard Lock{ g_Log.OutputLock };
+    do {
+        Dispatch({ Record.Level, Record.Length, Record.Time, Record.Text }, Record.KeptOnly);
+        ++Records;
+    } while (g_Log.Queue.TryPop(Record));
+
+    g_Log.Written.fetch_add(Records);
+    return Records;
+}
+
+void
+WriterMain() {
+    SetCurrentThreadName("Iron Log");
+
+    bool Pending{ false };
+    for (;;) {
+        // Read before draining so every line logged ahead of the request is included
+        const u64 Requested{ g_Log.FlushRequested.load() };
+        const bool Wrote{ WriteBatch() != 0 };
+
+        if (Requested != g_Log.FlushDone.load(std::memory_order_relaxed)) {
+            {
+                std::lock_guard Lock{ g_Log.OutputLock };
+                FlushSinks(true);
+            }
+            Pending = false;
+            g_Log.FlushDone.store(Requested);
+            continue;
+        }
+
+        if (Wrote) {
+            std::lock_guard Lock{ g_Log.OutputLock };
+            Pending = FlushSinks(false);
+            continue;
+        }
+
+        if (g_Log.Quit.load(std::memory_order_acquire)) {
+            break;
+        }
+
+        const auto Ready{ [] {
+            return g_Log.Pushed.load() != g_Log.Written.load()
+                || g_Log.FlushRequested.load() != g_Log.FlushDone.load()
+                || g_Log.Quit.load();
+        } };
 
+        std::unique_lock Lock{ g_Log.Lock };
+        g_Log.Sleeping.store(true);
+        if (Pending) {
+            // Buffering sinks get a chance to write out what they hold
+            if (!g_Log.Wake.wait_for(Lock, std::chrono::milliseconds(SinkFlushIntervalMs), Ready)) {
+                Lock.unlock();
+                std::lock_guard Output{ g_Log.OutputLock };
+                Pending = FlushSinks(false);
+            }
+        }
+        else {
+            g_Log.Wake.wait(Lock, Ready);
+        }
+        g_Log.Sleeping.store(false);
+    }
+
+    WriteBatch();
+
+    std::lock_guard Lock{ g_Log.OutputLock };
+    FlushSinks(true);
+}
+
+void
+WakeWriter() {
+    // Pairs with the Sleeping store and checks made under the lock by the writer
+    if (g_Log.Sleeping.load()) {
+        std::lock_guard Lock{ g_Log.Lock };
+        g_Log.Wake.notify_one();
+    }
+}
+
+// Lines that do not fit a record skip the queue, queued lines are flushed first to keep the order
+void
+WriteLongLine(LogLevel::Level Level, bool KeptOnly, u64 Time, const char* Prefix, u32 PrefixLength, const char* Msg, va_list Args) {
+    va_list Copy;
+    va_copy(Copy, Args);
+    const s32 MsgLength{ vsnprintf(nullptr, 0, Msg, Copy) };
+    va_end(Copy);
+
+    if (MsgLength < 0) {
+        return;
+    }
+
+    const u32 Length{ PrefixLength + (u32)MsgLength + 1 };
+    char* const Line{ (char*)MemAlloc(Length + 1, MemTag::Core) };
+    if (!Line) {
+        return;
+    }
+
+    memcpy(Line, Prefix, PrefixLength);
+    vsnprintf(Line + PrefixLength, (size_t)MsgLength + 1, Msg, Args);
+    Line[Length - 1] = '\n';
+
+    FlushLog();
+    WriteNow({ Level, Length, Time, Line }, KeptOnly);
+    MemFree(Line, MemTag::Core);
+}
+
+void
+LogText(LogLevel::Level Level, bool KeptOnly, const char* File, int Line, const char* Msg, va_list Args) {
     if (Level >= LogLevel::Count
-        || !g_EnabledLevels[Level]) {
+        || !g_EnabledLevels[Level].load(std::memory_order_relaxed)) {
         return;
     }
 
-    constexpr static const char* LevelText[]{
-        "\x1b[36m[DEBUG]\x1b[0m",
-        "\x1b[37m[INFO]\x1b[0m",
-        "\x1b[33m[WARNING]\x1b[0m",
-        "\x1b[31m[ERROR]\x1b[0m",
-        "\x1b[34m[FATAL]\x1b[0m"
-    };
+    LogRecord Record;
+    Record.Level = Level;
 
-    static_assert(_countof(LevelText) == LogLevel::Count, "Level text array size mismatch");
+    FILETIME Time;
+    GetSystemTimePreciseAsFileTime(&Time);
+    Record.Time = (u64)Time.dwHighDateTime << 32 | Time.dwLowDateTime;
+
+    s32 Prefix{ 0 };
+    if (g_IncludeFile.load(std::memory_order_relaxed)) {
+        Prefix = snprintf(Record.Text, LogLineSize, "%s:%i ", File, Line);
+        if (Prefix < 0 || (u32)Prefix >= LogLineSize) {
+            return;
+        }
+    }
+
+    va_list Copy;
+    va_copy(Copy, Args);
+    const s32 Length{ vsnprintf(Record.Text + Prefix, LogLineSize - Prefix, Msg, Copy) };
+    va_end(Copy);
 
+    // One byte is kept for the newline
+    if (Length < 0 || (u32)(Prefix + Length) >= LogLineSize - 1) UNLIKELY {
+        WriteLongLine(Level, KeptOnly, Record.Time, Record.Text, (u32)Prefix, Msg, Args);
+        return;
+    }
+
+    Record.Length = (u16)(Prefix + Length + 1);
+    Record.KeptOnly = KeptOnly;
+    Record.Text[Record.Length - 1] = '\n';
+
+    if (!g_Log.Running.load(std::memory_order_acquire)) {
+        WriteNow({ Level, Record.Length, Record.Time, Record.Text }, KeptOnly);
+        return;
+    }
+
+    // Back pressure, a full queue means the sinks cannot keep up
+    while (!g_Log.Queue.TryPush(Record)) {
+        WakeWriter();
+        std::this_thread::yield();
+    }
+
+    g_Log.Pushed.fetch_add(1);
+    WakeWriter();
+
+    if (Level == LogLevel::Fatal) {
+        FlushLog();
+    }
+}
+
+void
+LogToAllSinks(LogLevel::Level Level, const char* File, int Line, const char* Msg, ...) {
     va_list Args;
     va_start(Args, Msg);
+    LogText(Level, false, File, Line, Msg, Args);
+    va_end(Args);
+}
+
+constexpr u32
+AlignRecord(u32 Size) {
+    return (Size + 7) & ~7u;
+}
+
+u8*
+ReserveRecord(u32 Size) {
+    const u64 Start{ g_Binary.Offset.fetch_add(Size) };
+    if (Start + Size <= g_Binary.Capacity) {
+        return g_Binary.Base + Start;
+    }
+
+    // Straddles the end, the bytes before it still count so Close does not wait on them
+    if (Start < g_Binary.Capacity) {
+        g_Binary.Committed.fetch_add(g_Binary.Capacity - Start);
+    }
+
+    // The file is full, drops are counted in its header and reported once
+    if (Start < BinaryLogClosed && !g_Binary.Dropped.fetch_add(1, std::memory_order_relaxed)) {
+        LogToAllSinks(LogLevel::Warning, __FILE__, __LINE__,
+            "Binary log is full after %llu bytes, further events are dropped", g_Binary.Capacity);
+    }
+
+    return nullptr;
+}
+
+void
+CommitRecord(u8* Record, BinaryLog::RecordType::Type Type, u32 Size) {
+    std::atomic_ref<u32>{ ((BinaryLog::Record*)Record)->Type }.store(Type, std::memory_order_release);
+    g_Binary.Committed.fetch_add(Size, std::memory_order_release);
+}
+
+// Sites are written to the file the first time they log after it was opened
+u32
+GetSiteId(LogSite& Site) {
+    std::atomic_ref<u64> Id{ Site.Id };
+    const u64 Current{ Id.load(std::memory_order_acquire) };
+    if ((u32)(Current >> 32) == g_Binary.Generation.load(std::memory_order_relaxed)) {
+        return (u32)Current;
+    }
+
+    std::lock_guard Lock{ g_Binary.Lock };
+    const u32 Generation{ g_Binary.Generation.load(std::memory_order_relaxed) };
+    if ((u32)(Id.load(std::memory_order_relaxed) >> 32) == Generation) {
+        return (u32)Id.load(std::memory_order_relaxed);
+    }
+
+    const u16 FileLength{ (u16)Math::Min(strlen(Site.File), (size_t)max_u16) };
+    const u16 FormatLength{ (u16)Math::Min(strlen(Site.Format), (size_t)max_u16) };
+    const u32 Size{ AlignRecord(sizeof(BinaryLog::Site) + FileLength + FormatLength) };
+
+    u8* const Record{ ReserveRecord(Size) };
+    if (!Record) {
+        return 0;
+    }
+
+    const u32 NewId{ ++g_Binary.NextSite };
+
+    BinaryLog::Site* const S{ (BinaryLog::Site*)Record };
+    S->Header.Size = Size;
+    S->Id = NewId;
+    S->Level = Site.Level;
+    S->Line = Site.Line;
+    S->FileLength = FileLength;
+    S->FormatLength = FormatLength;
+    memcpy(S + 1, Site.File, FileLength);
+    memcpy((u8*)(S + 1) + FileLength, Site.Format, FormatLength);
+    CommitRecord(Record, BinaryLog::RecordType::Site, Size);
+
+    Id.store((u64)Generation << 32 | NewId, std::memory_order_release);
+    return NewId;
+}
+} // anonymous namespace
+
+LogMode::Mode
+GetLogMode(LogLevel::Level Level) {
+    if (Level >= LogLevel::Count
+        || !g_EnabledLevels[Level].load(std::memory_order_relaxed)) {
+        return LogMode::Off;
+    }
+
+    if (!g_Binary.Open.load(std::memory_order_relaxed)) {
+        return LogMode::Text;
+    }
+
+    return Level == LogLevel::Fatal || Level >= g_Log.KeptLevel.load(std::memory_order_relaxed)
+        ? LogMode::BinaryAndText : LogMode::Binary;
+}
+
+void
+LogBinary(LogSite& Site, const LogArgWriter& Args) {
+    const u32 SiteId{ GetSiteId(Site) };
+    if (!SiteId) {
+        return;
+    }
+
+    const u32 Size{ AlignRecord(sizeof(BinaryLog::Event) + Args.Size) };
+    u8* const Record{ ReserveRecord(Size) };
+    if (!Record) {
+        return;
+    }
+
+    if (!t_ThreadId) {
+        t_ThreadId = GetCurrentThreadId();
+    }
+
+    LARGE_INTEGER Ticks;
+    QueryPerformanceCounter(&Ticks);
+
+    BinaryLog::Event* const E{ (BinaryLog::Event*)Record };
+    E->Header.Size = Size;
+    E->Site = SiteId;
+    E->ThreadId = t_ThreadId;
+    E->Ticks = (u64)Ticks.QuadPart;
+    memcpy(E + 1, Args.Data, Args.Size);
+
+    // Before the commit, Close keeps the file mapped until then
+    if (Site.Level == LogLevel::Fatal) {
+        std::atomic_ref<u64>{ ((BinaryLog::Header*)g_Binary.Base)->Dropped }.store(
+            g_Binary.Dropped.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    CommitRecord(Record, BinaryLog::RecordType::Event, Size);
+
+    if (Site.Level == LogLevel::Fatal) {
+        FlushViewOfFile(g_Binary.Base, 0);
+    }
+}
+
+Result::Code
+OpenBinaryLog(const char* Path, u64 Capacity) {
+    if (!Path || Capacity <= sizeof(BinaryLog::Header)) {
+        return Result::EInvalidarg;
+    }
+
+    CloseBinaryLog();
+
+    std::lock_guard Lock{ g_Binary.Lock };
+
+    HANDLE File{ CreateFileA(Path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+        nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
+    if (File == INVALID_HANDLE_VALUE) {
+        return Result::EWritefile;
+    }
+
+    HANDLE Mapping{ CreateFileMappingA(File, nullptr, PAGE_READWRITE,
+        (DWORD)(Capacity >> 32), (DWORD)Capacity, nullptr) };
+    u8* const Base{ Mapping ? (u8*)MapViewOfFile(Mapping, FILE_MAP_WRITE, 0, 0, Capacity) : nullptr };
+    if (!Base) {
+        if (Mapping) {
+            CloseHandle(Mapping);
+        }
+        CloseHandle(File);
+        return Result::ENomemory;
+    }
+
+    LARGE_INTEGER Frequency;
+    LARGE_INTEGER Ticks;
+    FILETIME Time;
+    QueryPerformanceFrequency(&Frequency);
+    QueryPerformanceCounter(&Ticks);
+    GetSystemTimeAsFileTime(&Time);
+
+    BinaryLog::Header* const Header{ (BinaryLog::Header*)Base };
+    Header->Magic = BinaryLog::Magic;
+    Header->Version = BinaryLog::Version;
+    Header->TickFrequency = (u64)Frequency.QuadPart;
+    Header->StartTicks = (u64)Ticks.QuadPart;
+    Header->StartTime = (u64)Time.dwHighDateTime << 32 | Time.dwLowDateTime;
+    Header->Dropped = 0;
+
+    g_Binary.File = File;
+    g_Binary.Mapping = Mapping;
+    g_Binary.Base = Base;
+    g_Binary.Capacity = Capacity;
+    g_Binary.NextSite = 0;
+    g_Binary.Dropped.store(0);
+    g_Binary.Generation.fetch_add(1);
+    g_Binary.Committed.store(sizeof(BinaryLog::Header));
+    g_Binary.Offset.store(sizeof(BinaryLog::Header), std::memory_order_release);
+    g_Binary.Open.store(true, std::memory_order_release);
+
+    return Result::Ok;
+}
+
+void
+CloseBinaryLog() {
+    if (!g_Binary.Open.exchange(false)) {
+        return;
+    }
+
+    std::lock_guard Lock{ g_Binary.Lock };
 
-    if (g_IncludeFile) {
-        printf("%s %s:%i ", LevelText[(u32)Level], File, Line);
+    // Later reservations fail, earlier ones are waited for
+    const u64 Used{ Math::Min(g_Binary.Offset.exchange(BinaryLogClosed), g_Binary.Capacity) };
+    while (g_Binary.Committed.load(std::memory_order_acquire) < Used) {
+        std::this_thread::yield();
     }
-    else {
-        printf("%s ", LevelText[(u32)Level]);
+
+    const u64 Dropped{ g_Binary.Dropped.load() };
+    ((BinaryLog::Header*)g_Binary.Base)->Dropped = Dropped;
+    if (Dropped) {
+        LogToAllSinks(LogLevel::Warning, __FILE__, __LINE__,
+            "Binary log closed, %llu events did not fit", Dropped);
     }
 
-    vprintf(Msg, Args);
-    printf("\n");
+    FlushViewOfFile(g_Binary.Base, 0);
+    UnmapViewOfFile(g_Binary.Base);
+    CloseHandle(g_Binary.Mapping);
+
+    // Drop the unused tail of the reservation
+    LARGE_INTEGER End;
+    End.QuadPart = (LONGLONG)Used;
+    if (SetFilePointerEx(g_Binary.File, End, nullptr, FILE_BEGIN)) {
+        SetEndOfFile(g_Binary.File);
+    }
+    CloseHandle(g_Binary.File);
+
+    g_Binary.File = INVALID_HANDLE_VALUE;
+    g_Binary.Mapping = nullptr;
+    g_Binary.Base = nullptr;
+    g_Binary.Capacity = 0;
+}
+
+void
+Log(LogLevel::Level Level, const char* File, int Line, const char* Msg, ...) {
+    // Only Fatal and the levels of sinks kept with an open binary log reach here in binary mode
+    const bool KeptOnly{ Level != LogLevel::Fatal && g_Binary.Open.load(std::memory_order_relaxed) };
 
+    va_list Args;
+    va_start(Args, Msg);
+    LogText(Level, KeptOnly, File, Line, Msg, Args);
     va_end(Args);
 }
 
+Result::Code
+AddLogSink(ILogSink* Sink, LogLevel::Level MinLevel, u32 Flags) {
+    if (!Sink) {
+        return Result::EInvalidarg;
+    }
+
+    if (MinLevel >= LogLevel::Count) {
+        Sink->Release();
+        return Result::EInvalidarg;
+    }
+
+    std::lock_guard Lock{ g_Log.OutputLock };
+    if (g_Log.SinkCount == MaxLogSinks) {
+        Sink->Release();
+        return Result::ENomemory;
+    }
+
+    g_Log.Sinks[g_Log.SinkCount++] = { Sink, MinLevel, Flags };
+    UpdateKeptLevel();
+    return Result::Ok;
+}
+
+void
+RemoveLogSink(ILogSink* Sink) {
+    std::lock_guard Lock{ g_Log.OutputLock };
+    for (u32 I{ 0 }; I < g_Log.SinkCount; ++I) {
+        if (g_Log.Sinks[I].Sink == Sink) {
+            Sink->Flush(true);
+            Sink->Release();
+            g_Log.Sinks[I] = g_Log.Sinks[--g_Log.SinkCount];
+            UpdateKeptLevel();
+            return;
+        }
+    }
+}
+
+void
+RemoveAllLogSinks() {
+    std::lock_guard Lock{ g_Log.OutputLock };
+    for (u32 I{ 0 }; I < g_Log.SinkCount; ++I) {
+        g_Log.Sinks[I].Sink->Flush(true);
+        g_Log.Sinks[I].Sink->Release();
+    }
+
+    g_Log.SinkCount = 0;
+    UpdateKeptLevel();
+}
+
+Result::Code
+StartLogWriter() {
+    if (g_Log.Running.load()) {
+        return Result::Ok;
+    }
+
+    // The queue is never released, a thread that saw Running before StopLogWriter may still push.
+    // Its allocation is tagged Static so the leak report does not list it.
+    if (!g_Log.Queue.Capacity()) {
+        const Result::Code Res{ g_Log.Queue.Initialize(LogQueueCapacity) };
+        if (Result::Fail(Res)) {
+            return Res;
+        }
+    }
+
+    g_Log.Quit.store(false);
+    g_Log.Thread = std::thread(WriterMain);
+    g_Log.Running.store(true, std::memory_order_release);
+
+    return Result::Ok;
+}
+
+void
+StopLogWriter() {
+    if (!g_Log.Running.exchange(false)) {
+        return;
+    }
+
+    {
+        std::lock_guard Lock{ g_Log.Lock };
+        g_Log.Quit.store(true);
+    }
+    g_Log.Wake.notify_one();
+    g_Log.Thread.join();
+
+    FlushLog();
+}
+
+void
+FlushLog() {
+    if (g_Log.Running.load()) {
+        const u64 Request{ g_Log.FlushRequested.fetch_add(1) + 1 };
+        while (g_Log.FlushDone.load() < Request && g_Log.Running.load()) {
+            WakeWriter();
+            std::this_thread::yield();
+        }
+
+        if (g_Log.FlushDone.load() >= Request) {
+            return;
+        }
+    }
+
+    // Writer is gone, write the stragglers here
+    std::lock_guard Lock{ g_Log.OutputLock };
+    if (g_Log.Queue.Capacity()) {
+        LogRecord Record;
+        while (g_Log.Queue.TryPop(Record)) {
+            Dispatch({ Record.Level, Record.Length, Record.Time, Record.Text }, Record.KeptOnly);
+            g_Log.Written.fetch_add(1);
+        }
+    }
+
+    FlushSinks(true);
+}
+
 void
 EnableLogLevel(LogLevel::Level Level, bool Enable) {
     if (Level >= LogLevel::Count) {
         return;
     }
 
-    std::lock_guard Lock{ g_LogMutex };
-    g_EnabledLevels[Level] = Enable;
+    g_EnabledLevels[Level].store(Enable, std::memory_order_relaxed);
 }
 
 void
 EnableLogIncludePath(bool  Enable) {
-    std::lock_guard Lock{ g_LogMutex };
-    g_IncludeFile = Enable;
+    g_IncludeFile.store(Enable, std::memory_order_relaxed);
 }
 
 void
@@ -93,11 +724,20 @@ LogError(Result::Code Code, const char* File, int Line)
     if (Code >= Result::Count)
         return;
 
-    if (Code == Result::Ok) {
-        Log(LogLevel::Info, File, Line, g_Errors[Code]);
+    const LogLevel::Level Level{ Code == Result::Ok ? LogLevel::Info : LogLevel::Error };
+    const LogMode::Mode Mode{ GetLogMode(Level) };
+
+    if (Mode == LogMode::Text) {
+        Log(Level, File, Line, g_Errors[Code]);
     }
-    else {
-        Log(LogLevel::Error, File, Line, g_Errors[Code]);
+    else if (Mode != LogMode::Off) {
+        // The caller's location is only known here, so it travels with the arguments
+        static LogSite Sites[]{
+            { LogLevel::Info, __LINE__, __FILE__, "%s:%i %s" },
+            { LogLevel::Error, __LINE__, __FILE__, "%s:%i %s" },
+        };
+
+        LogAt(Mode, Sites[Level == LogLevel::Error], File, Line, g_Errors[Code]);
     }
 }
 }
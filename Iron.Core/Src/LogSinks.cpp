@@ -0,0 +1,337 @@
+#include <Iron.Core/Core.h>
+
+#include <Windows.h>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+
+namespace Iron {
+namespace {
+constexpr static const char* g_LevelTags[LogLevel::Count]{
+    "[DEBUG] ",
+    "[INFO] ",
+    "[WARNING] ",
+    "[ERROR] ",
+    "[FATAL] ",
+};
+
+constexpr u32 FileBufferSize{ 256 * 1024 };
+constexpr u64 FileWriteIntervalMs{ 1000 };
+constexpr u64 FileTimeTicksPerSecond{ 10000000 };
+constexpr u32 RingLineSize{ 256 };
+
+class CConsoleSink : public ILogSink {
+public:
+    void Release() override {
+        delete this;
+    }
+
+    void Write(const LogMessage& Message) override {
+        constexpr static const char* Colors[LogLevel::Count]{
+            "\x1b[36m",
+            "\x1b[37m",
+            "\x1b[33m",
+            "\x1b[31m",
+            "\x1b[34m",
+        };
+
+        const u32 TagLength{ (u32)strlen(g_LevelTags[Message.Level]) };
+        const u32 Length{ 5 + TagLength + 4 + Message.Length };
+        if (m_Used + Length > sizeof(m_Buffer)) {
+            Flush(true);
+        }
+
+        if (Length > sizeof(m_Buffer)) {
+            fputs(Colors[Message.Level], stdout);
+            fputs(g_LevelTags[Message.Level], stdout);
+            fputs("\x1b[0m", stdout);
+            fwrite(Message.Text, 1, Message.Length, stdout);
+            return;
+        }
+
+        // The tag without its trailing space is coloured
+        Append(Colors[Message.Level], 5);
+        Append(g_LevelTags[Message.Level], TagLength - 1);
+        Append("\x1b[0m ", 5);
+        Append(Message.Text, Message.Length);
+    }
+
+    bool Flush(bool) override {
+        if (m_Used) {
+            fwrite(m_Buffer, 1, m_Used, stdout);
+            m_Used = 0;
+        }
+
+        fflush(stdout);
+        return false;
+    }
+
+private:
+    char    m_Buffer[16 * 1024];
+    u32     m_Used{ 0 };
+
+    void Append(const char* Text, u32 Length) {
+        memcpy(m_Buffer + m_Used, Text, Length);
+        m_Used += Length;
+    }
+};
+
+class CFileSink : public ILogSink {
+public:
+    CFileSink(const char* Path, const LogFileRotation& Rotation)
+        : m_Rotation(Rotation) {
+        strcpy_s(m_Path, Path);
+    }
+
+    Result::Code Initialize() {
+        m_Buffer = (char*)MemAlloc(FileBufferSize, MemTag::Core);
+        if (!m_Buffer) {
+            return Result::ENomemory;
+        }
+
+        return Open(true);
+    }
+
+    void Release() override {
+        Flush(true);
+        if (m_File != INVALID_HANDLE_VALUE) {
+            CloseHandle(m_File);
+        }
+
+        MemFree(m_Buffer, MemTag::Core);
+        delete this;
+    }
+
+    void Write(const LogMessage& Message) override {
+        if (!m_Buffer) {
+            return;
+        }
+
+        if (!m_OpenTime) {
+            m_OpenTime = Message.Time;
+        }
+
+        FILETIME Time{ (DWORD)Message.Time, (DWORD)(Message.Time >> 32) };
+        SYSTEMTIME T{};
+        FileTimeToSystemTime(&Time, &T);
+
+        char Prefix[64];
+        const s32 PrefixLength{ snprintf(Prefix, sizeof(Prefix), "%04u-%02u-%02u %02u:%02u:%02u.%03u %s",
+            T.wYear, T.wMonth, T.wDay, T.wHour, T.wMinute, T.wSecond, T.wMilliseconds,
+            g_LevelTags[Message.Level]) };
+        const u64 Length{ (u64)PrefixLength + Message.Length };
+
+        const bool TooLarge{ m_Rotation.MaxBytes && m_FileBytes + m_Used + Length > m_Rotation.MaxBytes
+            && m_FileBytes + m_Used };
+        const bool TooOld{ m_Rotation.MaxSeconds
+            && Message.Time - m_OpenTime >= m_Rotation.MaxSeconds * FileTimeTicksPerSecond };
+        if (TooLarge || TooOld) {
+            WriteBuffer();
+            Open(true);
+            m_OpenTime = Message.Time;
+        }
+
+        if (m_Used + Length > FileBufferSize) {
+            WriteBuffer();
+        }
+
+        if (Length > FileBufferSize) {
+            WriteDirect(Prefix, (u32)PrefixLength);
+            WriteDirect(Message.Text, Message.Length);
+            return;
+        }
+
+        memcpy(m_Buffer + m_Used, Prefix, PrefixLength);
+        memcpy(m_Buffer + m_Used + PrefixLength, Message.Text, Message.Length);
+        m_Used += (u32)Length;
+    }
+
+    // Small batches are held back until the buffer fills up or a second has passed
+    bool Flush(bool Force) override {
+        if (m_Used && (Force || m_Used >= FileBufferSize / 2
+            || GetTickCount64() - m_LastWrite >= FileWriteIntervalMs)) {
+            WriteBuffer();
+        }
+
+        return m_Used != 0;
+    }
+
+private:
+    char            m_Path[IRON_MAX_PATH]{};
+    LogFileRotation m_Rotation;
+    HANDLE          m_File{ INVALID_HANDLE_VALUE };
+    char*           m_Buffer{};
+    u32             m_Used{ 0 };
+    u64             m_FileBytes{ 0 };
+    u64             m_OpenTime{ 0 };
+    u64             m_LastWrite{ 0 };
+
+    void WriteDirect(const char* Data, u32 Length) {
+        DWORD Written{ 0 };
+        if (m_File != INVALID_HANDLE_VALUE && ::WriteFile(m_File, Data, Length, &Written, nullptr)) {
+            m_FileBytes += Written;
+        }
+    }
+
+    void WriteBuffer() {
+        if (m_Used) {
+            WriteDirect(m_Buffer, m_Used);
+            m_Used = 0;
+        }
+
+        m_LastWrite = GetTickCount64();
+    }
+
+    // Name.ext becomes Name.Index.ext
+    void RotatedPath(char* Out, u32 Index) const {
+        const char* const Dot{ strrchr(m_Path, '.') };
+        const char* const Slash{ strrchr(m_Path, '\\') };
+        if (!Dot || (Slash && Dot < Slash)) {
+            snprintf(Out, IRON_MAX_PATH, "%s.%u", m_Path, Index);
+            return;
+        }
+
+        snprintf(Out, IRON_MAX_PATH, "%.*s.%u%s", (int)(Dot - m_Path), m_Path, Index, Dot);
+    }
+
+    Result::Code Open(bool Rotate) {
+        if (m_File != INVALID_HANDLE_VALUE) {
+            CloseHandle(m_File);
+            m_File = INVALID_HANDLE_VALUE;
+        }
+
+        if (Rotate) {
+            char From[IRON_MAX_PATH];
+            char To[IRON_MAX_PATH];
+            for (u32 I{ m_Rotation.KeepFiles }; I > 1; --I) {
+                RotatedPath(From, I - 1);
+                RotatedPath(To, I);
+                MoveFileExA(From, To, MOVEFILE_REPLACE_EXISTING);
+            }
+
+            if (m_Rotation.KeepFiles) {
+                RotatedPath(To, 1);
+                MoveFileExA(m_Path, To, MOVEFILE_REPLACE_EXISTING);
+            }
+        }
+
+        m_File = CreateFileA(m_Path, GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+            CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        m_FileBytes = 0;
+        m_OpenTime = 0;
+
+        return m_File != INVALID_HANDLE_VALUE ? Result::Ok : Result::EWritefile;
+    }
+};
+
+class CRingSink : public ILogRingSink {
+public:
+    explicit CRingSink(u32 Count)
+        : m_Count(Count) {
+    }
+
+    Result::Code Initialize() {
+        m_Lines = (char*)MemAlloc((u64)m_Count * RingLineSize, MemTag::Core);
+        return m_Lines ? Result::Ok : Result::ENomemory;
+    }
+
+    void Release() override {
+        MemFree(m_Lines, MemTag::Core);
+        delete this;
+    }
+
+    void Write(const LogMessage& Message) override {
+        std::lock_guard Lock{ m_Lock };
+
+        // Lines are stored null terminated and cut to the slot size
+        char* const Line{ m_Lines + (u64)(m_Next % m_Count) * RingLineSize };
+        const u32 TagLength{ (u32)strlen(g_LevelTags[Message.Level]) };
+        const u32 TextLength{ Math::Min(Message.Length, RingLineSize - 1 - TagLength) };
+        memcpy(Line, g_LevelTags[Message.Level], TagLength);
+        memcpy(Line + TagLength, Message.Text, TextLength);
+        Line[TagLength + TextLength] = 0;
+        ++m_Next;
+    }
+
+    bool Flush(bool) override {
+        return false;
+    }
+
+    u32 CopyRecent(char* Buffer, u32 Size) override {
+        if (!Buffer || !Size) {
+            return 0;
+        }
+
+        // A crash may have happened while the lock was held, copy regardless
+        const bool Locked{ m_Lock.try_lock() };
+
+        u32 Used{ 0 };
+        const u64 First{ m_Next > m_Count ? m_Next - m_Count : 0 };
+        for (u64 I{ First }; I < m_Next; ++I) {
+            const char* const Line{ m_Lines + (I % m_Count) * RingLineSize };
+            const u32 Length{ (u32)strnlen(Line, RingLineSize) };
+            if (Used + Length + 1 > Size) {
+                break;
+            }
+
+            memcpy(Buffer + Used, Line, Length);
+            Used += Length;
+
+            // Cut lines lose their newline
+            if (Length && Line[Length - 1] != '\n' && Used + 2 <= Size) {
+                Buffer[Used++] = '\n';
+            }
+        }
+
+        Buffer[Used] = 0;
+
+        if (Locked) {
+            m_Lock.unlock();
+        }
+
+        return Used;
+    }
+
+private:
+    std::mutex  m_Lock;
+    char*       m_Lines{};
+    u32         m_Count;
+    u64         m_Next{ 0 };
+};
+} // anonymous namespace
+
+ILogSink*
+CreateConsoleLogSink() {
+    return new (std::nothrow) CConsoleSink{};
+}
+
+ILogSink*
+CreateFileLogSink(const char* Path, const LogFileRotation& Rotation) {
+    if (!Path || strlen(Path) >= IRON_MAX_PATH) {
+        return nullptr;
+    }
+
+    CFileSink* const Sink{ new (std::nothrow) CFileSink{ Path, Rotation } };
+    if (Sink && Result::Fail(Sink->Initialize())) {
+        Sink->Release();
+        return nullptr;
+    }
+
+    return Sink;
+}
+
+ILogRingSink*
+CreateRingLogSink(u32 MessageCount) {
+    if (!MessageCount) {
+        return nullptr;
+    }
+
+    CRingSink* const Sink{ new (std::nothrow) CRingSink{ MessageCount } };
+    if (Sink && Result::Fail(Sink->Initialize())) {
+        Sink->Release();
+        return nullptr;
+    }
+
+    return Sink;
+}
+}
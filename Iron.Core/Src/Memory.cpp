@@ -1,16 +1,423 @@
 #include <Iron.Core/Core.h>
+#include <Iron.Core/Src/PoolAllocator.h>
 
+#include <Windows.h>
+#include <atomic>
+#include <malloc.h>
 #include <memory>
+#include <mutex>
+#include <stdint.h>
 
 namespace Iron {
+namespace {
+constexpr static const char* g_TagNames[MemTag::Count]{
+    "General",
+    "Core",
+    "RHI",
+    "FrameGraph",
+    "Assets",
+    "Scripting",
+    "Audio",
+    "Static",
+};
+
+// Bytes a thread allocates or frees under one tag before they are folded into the shared
+// counters, peaks and budgets are only checked when that happens
+constexpr s64 FoldBytes{ 256 * 1024 };
+
+#ifdef _DEBUG
+constexpr u32 BlockMagic{ 0x4b4c4249 };
+
+// Debug blocks remember their tag so a free with another tag is caught
+struct alignas(MemDefaultAlignment) BlockHeader {
+    u32     Magic;
+    u32     Tag;
+};
+
+constexpr size_t HeaderSize{ sizeof(BlockHeader) };
+#else
+constexpr size_t HeaderSize{ 0 };
+#endif
+
+// Shared by all threads, only touched when a thread folds its counts in or exits
+struct alignas(CacheLineSize) TagCounters {
+    std::atomic<s64>                LiveBytes{};
+    std::atomic<u64>                PeakBytes{};
+    std::atomic<s64>                LiveAllocations{};  // Of exited threads
+    std::atomic<u64>                TotalAllocations{}; // Of exited threads
+    std::atomic<u64>                Budget{};
+    std::atomic<MemBudgetCallback>  Callback{};
+    std::atomic<void*>              UserData{};
+    std::atomic<bool>               OverBudget{};
+};
+
+// Written by the owning thread only, atomic so GetMemTagStats can read them
+struct ThreadTagCounters {
+    std::atomic<s64>    Bytes;          // Not folded yet
+    std::atomic<s64>    Allocations;
+    std::atomic<u64>    Total;
+};
+
+struct ThreadCounters {
+    ThreadTagCounters   Tags[MemTag::Count]{};
+    ThreadCounters*     Prev{};
+    ThreadCounters*     Next{};
+    bool                Linked{};
+    bool                Dead{};
+
+    ~ThreadCounters();
+};
+
+struct ThreadList {
+    std::mutex          Lock{};
+    ThreadCounters*     Head{};
+};
+
+TagCounters g_Tags[MemTag::Count]{};
+ThreadList  g_Threads{};
+
+thread_local ThreadCounters t_Counters{};
+
+AllocatorBackend::Type
+SelectBackend() {
+    char Value[16]{};
+    const DWORD Length{ GetEnvironmentVariableA("IRON_ALLOCATOR", Value, sizeof(Value)) };
+
+    if (Length && Length < sizeof(Value)) {
+        if (_stricmp(Value, "crt") == 0) {
+            return AllocatorBackend::Crt;
+        }
+
+        if (_stricmp(Value, "pool") == 0) {
+            return AllocatorBackend::Pool;
+        }
+    }
+
+    return AllocatorBackend::Pool;
+}
+
+// Chosen once, every block must be freed by the backend that allocated it
+inline AllocatorBackend::Type
+Backend() {
+    static const AllocatorBackend::Type Selected{ SelectBackend() };
+    return Selected;
+}
+
+
+inline void*
+BackendAlloc(size_t Size) {
+    if (Backend() == AllocatorBackend::Pool) {
+        return Pool::Allocate(Size);
+    }
+
+    return malloc(Size);
+}
+
+inline void
+BackendFree(void* Block) {
+    if (Backend() == AllocatorBackend::Pool) {
+        Pool::Free(Block);
+        return;
+    }
+
+    free(Block);
+}
+
+inline size_t
+BackendSize(const void* Block) {
+    if (Backend() == AllocatorBackend::Pool) {
+        return Pool::UsableSize(Block);
+    }
+
+    return _msize((void*)Block);
+}
+
+inline MemTag::Tag
+ValidateTag(MemTag::Tag Tag) {
+    return Tag < MemTag::Count ? Tag : MemTag::General;
+}
+
+// Single writer, a plain load and store instead of a locked add
+template<typename T>
+inline void
+Bump(std::atomic<T>& Counter, T Delta) {
+    Counter.store(Counter.load(std::memory_order_relaxed) + Delta, std::memory_order_relaxed);
+}
+
+void
+Fold(MemTag::Tag Tag, s64 Bytes) {
+    TagCounters& C{ g_Tags[Tag] };
+
+    const s64 Live{ C.LiveBytes.fetch_add(Bytes, std::memory_order_relaxed) + Bytes };
+    const u64 Budget{ C.Budget.load(std::memory_order_relaxed) };
+    if (Live <= 0) {
+        C.OverBudget.store(false, std::memory_order_relaxed);
+        return;
+    }
+
+    u64 Peak{ C.PeakBytes.load(std::memory_order_relaxed) };
+    while ((u64)Live > Peak
+        && !C.PeakBytes.compare_exchange_weak(Peak, (u64)Live, std::memory_order_relaxed)) {
+    }
+
+    if (!Budget || (u64)Live <= Budget) {
+        if (C.OverBudget.load(std::memory_order_relaxed)) {
+            C.OverBudget.store(false, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    if (!C.OverBudget.exchange(true, std::memory_order_relaxed)) {
+        const MemBudgetCallback Callback{ C.Callback.load(std::memory_order_acquire) };
+        if (Callback) {
+            Callback(Tag, (u64)Live, Budget, C.UserData.load(std::memory_order_relaxed));
+        }
+    }
+}
+
+ThreadCounters::~ThreadCounters() {
+    if (Linked) {
+        std::lock_guard Lock{ g_Threads.Lock };
+        for (u32 I{ 0 }; I < MemTag::Count; ++I) {
+            ThreadTagCounters& T{ Tags[I] };
+            g_Tags[I].LiveAllocations.fetch_add(T.Allocations.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            g_Tags[I].TotalAllocations.fetch_add(T.Total.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            Fold((MemTag::Tag)I, T.Bytes.load(std::memory_order_relaxed));
+        }
+
+        if (Prev) {
+            Prev->Next = Next;
+        }
+        else {
+            g_Threads.Head = Next;
+        }
+        if (Next) {
+            Next->Prev = Prev;
+        }
+        Linked = false;
+    }
+
+    // Frees from later thread_local destructors go straight to the shared counters
+    Dead = true;
+}
+
+void
+LinkThread(ThreadCounters& Counters) {
+    std::lock_guard Lock{ g_Threads.Lock };
+    Counters.Next = g_Threads.Head;
+    if (g_Threads.Head) {
+        g_Threads.Head->Prev = &Counters;
+    }
+    g_Threads.Head = &Counters;
+    Counters.Linked = true;
+}
+
+void
+Track(MemTag::Tag Tag, s64 Bytes, s64 Allocations) {
+    ThreadCounters& Counters{ t_Counters };
+
+    if (Counters.Dead) UNLIKELY {
+        TagCounters& C{ g_Tags[Tag] };
+        C.LiveAllocations.fetch_add(Allocations, std::memory_order_relaxed);
+        if (Allocations > 0) {
+            C.TotalAllocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        Fold(Tag, Bytes);
+        return;
+    }
+
+    if (!Counters.Linked) UNLIKELY {
+        LinkThread(Counters);
+    }
+
+    ThreadTagCounters& T{ Counters.Tags[Tag] };
+    Bump(T.Allocations, Allocations);
+    if (Allocations > 0) {
+        Bump(T.Total, 1ull);
+    }
+
+    const s64 Pending{ T.Bytes.load(std::memory_order_relaxed) + Bytes };
+    if (Pending >= FoldBytes || Pending <= -FoldBytes) UNLIKELY {
+        T.Bytes.store(0, std::memory_order_relaxed);
+        Fold(Tag, Pending);
+    }
+    else {
+        T.Bytes.store(Pending, std::memory_order_relaxed);
+    }
+}
+} // anonymous namespace
+
 void*
 MemAlloc(size_t Size) {
-    return malloc(Size);
+    return MemAlloc(Size, MemTag::General);
 }
 
 void
 MemFree(void* Block) {
-    free(Block);
+    MemFree(Block, MemTag::General);
+}
+
+void*
+MemAlloc(size_t Size, MemTag::Tag Tag) {
+    Tag = ValidateTag(Tag);
+
+    u8* Block{ (u8*)BackendAlloc(Size + HeaderSize) };
+    if (!Block) {
+        return nullptr;
+    }
+
+    Track(Tag, (s64)BackendSize(Block), 1);
+
+#ifdef _DEBUG
+    BlockHeader* Header{ (BlockHeader*)Block };
+    Header->Magic = BlockMagic;
+    Header->Tag = Tag;
+#endif
+
+    return Block + HeaderSize;
+}
+
+void
+MemFree(void* Block, MemTag::Tag Tag) {
+    if (!Block) {
+        return;
+    }
+
+    u8* Base{ (u8*)Block - HeaderSize };
+    Tag = ValidateTag(Tag);
+
+#ifdef _DEBUG
+    BlockHeader* Header{ (BlockHeader*)Base };
+    if (Header->Magic != BlockMagic) {
+        LOG_ERROR("MemFree() called with a block not returned by MemAlloc() or freed twice!");
+        return;
+    }
+
+    if (Header->Tag != Tag) {
+        LOG_ERROR("MemFree() called with tag %s for a block allocated as %s!",
+            g_TagNames[Tag], g_TagNames[Header->Tag]);
+        Tag = (MemTag::Tag)Header->Tag;
+    }
+
+    Header->Magic = 0;
+#endif
+
+    Track(Tag, -(s64)BackendSize(Base), -1);
+    BackendFree(Base);
+}
+
+size_t
+MemSize(const void* Block) {
+    return Block ? BackendSize((const u8*)Block - HeaderSize) - HeaderSize : 0;
+}
+
+void*
+MemAllocAligned(size_t Size, size_t Alignment) {
+    return MemAllocAligned(Size, Alignment, MemTag::General);
+}
+
+void*
+MemAllocAligned(size_t Size, size_t Alignment, MemTag::Tag Tag) {
+    if (!Alignment || (Alignment & (Alignment - 1))) UNLIKELY {
+        return nullptr;
+    }
+
+    // The original block is stored right before the aligned pointer
+    Alignment = Math::Max(Alignment, sizeof(void*));
+    u8* Block{ (u8*)MemAlloc(Size + Alignment + sizeof(void*), Tag) };
+    if (!Block) {
+        return nullptr;
+    }
+
+    u8* Aligned{ (u8*)Math::AlignUp((uintptr_t)(Block + sizeof(void*)), (uintptr_t)Alignment) };
+    ((void**)Aligned)[-1] = Block;
+
+    return Aligned;
+}
+
+void
+MemFreeAligned(void* Block) {
+    MemFreeAligned(Block, MemTag::General);
+}
+
+void
+MemFreeAligned(void* Block, MemTag::Tag Tag) {
+    if (!Block) {
+        return;
+    }
+
+    MemFree(((void**)Block)[-1], Tag);
+}
+
+AllocatorBackend::Type
+GetAllocatorBackend() {
+    return Backend();
+}
+
+const char*
+GetMemTagName(MemTag::Tag Tag) {
+    return g_TagNames[ValidateTag(Tag)];
+}
+
+MemTagStats
+GetMemTagStats(MemTag::Tag Tag) {
+    Tag = ValidateTag(Tag);
+    const TagCounters& C{ g_Tags[Tag] };
+
+    // Held so exiting threads can't be counted twice or not at all
+    std::lock_guard Lock{ g_Threads.Lock };
+
+    s64 LiveBytes{ C.LiveBytes.load(std::memory_order_relaxed) };
+    s64 LiveAllocations{ C.LiveAllocations.load(std::memory_order_relaxed) };
+    u64 TotalAllocations{ C.TotalAllocations.load(std::memory_order_relaxed) };
+    for (const ThreadCounters* Thread{ g_Threads.Head }; Thread; Thread = Thread->Next) {
+        const ThreadTagCounters& T{ Thread->Tags[Tag] };
+        LiveBytes += T.Bytes.load(std::memory_order_relaxed);
+        LiveAllocations += T.Allocations.load(std::memory_order_relaxed);
+        TotalAllocations += T.Total.load(std::memory_order_relaxed);
+    }
+
+    MemTagStats Stats{};
+    Stats.LiveBytes = LiveBytes > 0 ? (u64)LiveBytes : 0;
+    Stats.PeakBytes = Math::Max(C.PeakBytes.load(std::memory_order_relaxed), Stats.LiveBytes);
+    Stats.LiveAllocations = LiveAllocations > 0 ? (u64)LiveAllocations : 0;
+    Stats.TotalAllocations = TotalAllocations;
+    Stats.Budget = C.Budget.load(std::memory_order_relaxed);
+    return Stats;
+}
+
+void
+SetMemTagBudget(MemTag::Tag Tag, u64 Budget, MemBudgetCallback Callback, void* UserData) {
+    TagCounters& C{ g_Tags[ValidateTag(Tag)] };
+
+    C.UserData.store(UserData, std::memory_order_relaxed);
+    C.Callback.store(Callback, std::memory_order_release);
+    C.OverBudget.store(false, std::memory_order_relaxed);
+    C.Budget.store(Budget, std::memory_order_relaxed);
+}
+
+void
+ReportMemoryLeaks() {
+    u64 LeakedBytes{ 0 };
+
+    for (u32 I{ 0 }; I < MemTag::Count; ++I) {
+        const MemTagStats Stats{ GetMemTagStats((MemTag::Tag)I) };
+        if (I == MemTag::Static || !Stats.LiveAllocations) {
+            continue;
+        }
+
+        LeakedBytes += Stats.LiveBytes;
+        LOG_WARNING("Memory leak in %s: %llu bytes in %llu allocations (peak %llu bytes, %llu allocations total)",
+            g_TagNames[I],
+            Stats.LiveBytes,
+            Stats.LiveAllocations,
+            Stats.PeakBytes,
+            Stats.TotalAllocations);
+    }
+
+    if (!LeakedBytes) {
+        LOG_INFO("No memory leaks detected");
+    }
 }
 
 void
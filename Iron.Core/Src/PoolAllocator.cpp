@@ -0,0 +1,347 @@
+#include <Iron.Core/Src/PoolAllocator.h>
+
+#include <Windows.h>
+#include <mutex>
+#include <stdint.h>
+
+namespace Iron::Pool {
+namespace {
+constexpr u32 SpanMagic{ 0x4e415053 };
+constexpr u32 LargeClass{ max_u32 };
+constexpr u64 HeaderSize{ 64 };
+constexpr u32 SpansPerRegion{ 64 };
+constexpr u64 LargePageSize{ 4096 };
+
+constexpr u32 g_ClassSizes[]{
+    16, 32, 48, 64, 80, 96, 112, 128,
+    160, 192, 224, 256,
+    320, 384, 448, 512,
+    640, 768, 896, 1024,
+    1280, 1536, 1792, 2048,
+    2560, 3072, 3584, 4096,
+    5120, 6144, 7168, 8192,
+    10240, 12288, 14336, 16384,
+};
+
+constexpr u32 NumClasses{ (u32)(sizeof(g_ClassSizes) / sizeof(g_ClassSizes[0])) };
+
+static_assert(g_ClassSizes[NumClasses - 1] == MaxSmallSize, "Largest size class must match MaxSmallSize");
+
+struct ClassLookup {
+    u8          Index[MaxSmallSize / 16 + 1];
+
+    constexpr ClassLookup() : Index() {
+        u32 Class{ 0 };
+        for (u32 I{ 0 }; I <= MaxSmallSize / 16; ++I) {
+            while (g_ClassSizes[Class] < I * 16) {
+                ++Class;
+            }
+            Index[I] = (u8)Class;
+        }
+    }
+};
+
+constexpr ClassLookup g_Lookup{};
+
+constexpr inline u32
+SizeToClass(size_t Size) {
+    return g_Lookup.Index[(Size + 15) >> 4];
+}
+
+// Objects moved between a thread cache and the central list at once
+constexpr inline u32
+BatchCount(u32 Class) {
+    return Math::Max(2u, Math::Min(128u, 32768u / g_ClassSizes[Class]));
+}
+
+struct alignas(64) SpanHeader {
+    u32             Magic;
+    u32             SizeClass;
+    u64             MappedSize;
+};
+
+static_assert(sizeof(SpanHeader) == HeaderSize, "Span header size mismatch");
+
+struct FreeObject {
+    FreeObject*     Next;
+};
+
+struct alignas(64) CentralList {
+    std::mutex      Lock{};
+    FreeObject*     Head{};
+    u32             Count{};
+};
+
+struct PageHeap {
+    std::mutex      Lock{};
+    u8*             Cursor{};
+    u8*             End{};
+};
+
+CentralList g_Central[NumClasses]{};
+PageHeap    g_PageHeap{};
+
+inline SpanHeader*
+SpanOf(const void* Block) {
+    return (SpanHeader*)((uintptr_t)Block & ~(uintptr_t)(SpanSize - 1));
+}
+
+u8*
+AllocateSpan() {
+    std::lock_guard Lock{ g_PageHeap.Lock };
+
+    if (g_PageHeap.Cursor == g_PageHeap.End) {
+        // Reservations are aligned to the 64KB allocation granularity, so spans are too
+        u8* Region{ (u8*)VirtualAlloc(nullptr, SpanSize * SpansPerRegion, MEM_RESERVE, PAGE_NOACCESS) };
+        if (!Region) {
+            return nullptr;
+        }
+
+        g_PageHeap.Cursor = Region;
+        g_PageHeap.End = Region + SpanSize * SpansPerRegion;
+    }
+
+    u8* Span{ (u8*)VirtualAlloc(g_PageHeap.Cursor, SpanSize, MEM_COMMIT, PAGE_READWRITE) };
+    if (!Span) {
+        return nullptr;
+    }
+
+    g_PageHeap.Cursor += SpanSize;
+
+    return Span;
+}
+
+// Carves a fresh span into a linked list of objects, returns the object count
+u32
+CarveSpan(u32 Class, FreeObject*& Head, FreeObject*& Tail) {
+    u8* Span{ AllocateSpan() };
+    if (!Span) {
+        return 0;
+    }
+
+    SpanHeader* Header{ (SpanHeader*)Span };
+    Header->Magic = SpanMagic;
+    Header->SizeClass = Class;
+    Header->MappedSize = SpanSize;
+
+    const u32 ObjectSize{ g_ClassSizes[Class] };
+    const u32 Count{ (u32)((SpanSize - HeaderSize) / ObjectSize) };
+
+    u8* Object{ Span + HeaderSize };
+    Head = (FreeObject*)Object;
+
+    for (u32 I{ 0 }; I + 1 < Count; ++I) {
+        ((FreeObject*)Object)->Next = (FreeObject*)(Object + ObjectSize);
+        Object += ObjectSize;
+    }
+
+    Tail = (FreeObject*)Object;
+    Tail->Next = nullptr;
+
+    return Count;
+}
+
+void
+ReleaseToCentral(u32 Class, FreeObject* Head, FreeObject* Tail, u32 Count) {
+    CentralList& Central{ g_Central[Class] };
+
+    std::lock_guard Lock{ Central.Lock };
+    Tail->Next = Central.Head;
+    Central.Head = Head;
+    Central.Count += Count;
+}
+
+u32
+FetchFromCentral(u32 Class, FreeObject*& Head, u32 Want) {
+    CentralList& Central{ g_Central[Class] };
+
+    {
+        std::lock_guard Lock{ Central.Lock };
+        if (Central.Head) {
+            FreeObject* First{ Central.Head };
+            FreeObject* Last{ First };
+            u32 Count{ 1 };
+
+            while (Count < Want && Last->Next) {
+                Last = Last->Next;
+                ++Count;
+            }
+
+            Central.Head = Last->Next;
+            Central.Count -= Count;
+            Last->Next = nullptr;
+
+            Head = First;
+            return Count;
+        }
+    }
+
+    FreeObject* First{};
+    FreeObject* Tail{};
+    const u32 Carved{ CarveSpan(Class, First, Tail) };
+    if (!Carved) {
+        Head = nullptr;
+        return 0;
+    }
+
+    if (Carved <= Want) {
+        Head = First;
+        return Carved;
+    }
+
+    FreeObject* Last{ First };
+    for (u32 I{ 1 }; I < Want; ++I) {
+        Last = Last->Next;
+    }
+
+    ReleaseToCentral(Class, Last->Next, Tail, Carved - Want);
+    Last->Next = nullptr;
+
+    Head = First;
+    return Want;
+}
+
+struct ThreadCache {
+    struct List {
+        FreeObject*     Head;
+        u32             Count;
+    };
+
+    List            Lists[NumClasses]{};
+    bool            Dead{};
+
+    ~ThreadCache() {
+        for (u32 Class{ 0 }; Class < NumClasses; ++Class) {
+            List& L{ Lists[Class] };
+            if (!L.Head) {
+                continue;
+            }
+
+            FreeObject* Tail{ L.Head };
+            while (Tail->Next) {
+                Tail = Tail->Next;
+            }
+
+            ReleaseToCentral(Class, L.Head, Tail, L.Count);
+            L = {};
+        }
+
+        // Frees from later thread_local destructors go straight to the central lists
+        Dead = true;
+    }
+};
+
+thread_local ThreadCache t_Cache{};
+
+void*
+AllocateLarge(size_t Size) {
+    const u64 Mapped{ Math::AlignUp((u64)Size + HeaderSize, LargePageSize) };
+
+    u8* Base{ (u8*)VirtualAlloc(nullptr, Mapped, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE) };
+    if (!Base) {
+        return nullptr;
+    }
+
+    SpanHeader* Header{ (SpanHeader*)Base };
+    Header->Magic = SpanMagic;
+    Header->SizeClass = LargeClass;
+    Header->MappedSize = Mapped;
+
+    return Base + HeaderSize;
+}
+} // anonymous namespace
+
+void*
+Allocate(size_t Size) {
+    if (Size > MaxSmallSize) {
+        return AllocateLarge(Size);
+    }
+
+    const u32 Class{ SizeToClass(Size) };
+    ThreadCache& Cache{ t_Cache };
+
+    if (Cache.Dead) UNLIKELY {
+        FreeObject* Object{};
+        FetchFromCentral(Class, Object, 1);
+        return Object;
+    }
+
+    ThreadCache::List& L{ Cache.Lists[Class] };
+    if (!L.Head) {
+        L.Count = FetchFromCentral(Class, L.Head, BatchCount(Class));
+        if (!L.Head) {
+            return nullptr;
+        }
+    }
+
+    FreeObject* Object{ L.Head };
+    L.Head = Object->Next;
+    --L.Count;
+
+    return Object;
+}
+
+void
+Free(void* Block) {
+    if (!Block) {
+        return;
+    }
+
+    SpanHeader* Header{ SpanOf(Block) };
+
+#ifdef _DEBUG
+    if (Header->Magic != SpanMagic) {
+        LOG_ERROR("MemFree() called with a block not owned by the pool allocator!");
+        return;
+    }
+#endif
+
+    if (Header->SizeClass == LargeClass) {
+        VirtualFree(Header, 0, MEM_RELEASE);
+        return;
+    }
+
+    const u32 Class{ Header->SizeClass };
+    FreeObject* Object{ (FreeObject*)Block };
+    ThreadCache& Cache{ t_Cache };
+
+    if (Cache.Dead) UNLIKELY {
+        ReleaseToCentral(Class, Object, Object, 1);
+        return;
+    }
+
+    ThreadCache::List& L{ Cache.Lists[Class] };
+    Object->Next = L.Head;
+    L.Head = Object;
+    ++L.Count;
+
+    const u32 Batch{ BatchCount(Class) };
+    if (L.Count > Batch * 2) {
+        // Hand a batch back so memory freed on this thread can be reused by others
+        FreeObject* First{ L.Head };
+        FreeObject* Last{ First };
+        for (u32 I{ 1 }; I < Batch; ++I) {
+            Last = Last->Next;
+        }
+
+        L.Head = Last->Next;
+        L.Count -= Batch;
+
+        ReleaseToCentral(Class, First, Last, Batch);
+    }
+}
+
+size_t
+UsableSize(const void* Block) {
+    if (!Block) {
+        return 0;
+    }
+
+    const SpanHeader* Header{ SpanOf(Block) };
+    if (Header->SizeClass == LargeClass) {
+        return (size_t)(Header->MappedSize - HeaderSize);
+    }
+
+    return g_ClassSizes[Header->SizeClass];
+}
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <Iron.Core/Core.h>
+
+// Size class allocator backing MemAlloc/MemFree when AllocatorBackend::Pool is selected.
+// Small blocks come from 64KB spans carved into fixed size classes, each thread keeps
+// a free list cache per class and exchanges batches with a shared central list.
+// Blocks larger than MaxSmallSize are mapped directly from the OS.
+namespace Iron::Pool {
+constexpr u32 SpanLog2{ 16 };
+constexpr u64 SpanSize{ 1ull << SpanLog2 };
+constexpr u32 MaxSmallSize{ 16 * 1024 };
+
+void* Allocate(size_t Size);
+void Free(void* Block);
+size_t UsableSize(const void* Block);
+}
@@ -0,0 +1,85 @@
+#include <Iron.Core/Core.h>
+
+#include <stdint.h>
+
+namespace Iron {
+namespace {
+// Address space reserved per thread, pages are only committed as they are touched
+constexpr u64 ScratchReserveSize{ 256ull * 1024 * 1024 };
+constexpr u64 ScratchCommitSize{ 64 * 1024 };
+
+struct ThreadScratch {
+    u8*             Base{};
+    u64             Offset{};
+    u64             Committed{};
+
+    ~ThreadScratch() {
+        if (Base) {
+            VirtualRelease(Base, ScratchReserveSize);
+        }
+    }
+};
+
+thread_local ThreadScratch t_Scratch{};
+} // anonymous namespace
+
+void*
+ScratchAlloc(u64 Size, u64 Alignment) {
+    if (!Alignment || (Alignment & (Alignment - 1))) UNLIKELY {
+        return nullptr;
+    }
+
+    ThreadScratch& S{ t_Scratch };
+    if (!S.Base) UNLIKELY {
+        S.Base = (u8*)VirtualReserve(ScratchReserveSize);
+        if (!S.Base) {
+            return nullptr;
+        }
+    }
+
+    const u64 Start{ Math::AlignUp(S.Offset, Alignment) };
+    const u64 End{ Start + Size };
+
+    if (End > S.Committed) {
+        const u64 NewCommitted{ Math::AlignUp(End, ScratchCommitSize) };
+        if (NewCommitted > ScratchReserveSize) UNLIKELY {
+            LOG_FATAL("Scratch memory exhausted, requested %llu bytes with %llu in use", Size, S.Offset);
+            return nullptr;
+        }
+
+        if (!VirtualCommit(S.Base + S.Committed, NewCommitted - S.Committed)) {
+            return nullptr;
+        }
+
+        S.Committed = NewCommitted;
+    }
+
+    S.Offset = End;
+
+    return S.Base + Start;
+}
+
+ScratchMarker
+GetScratchMarker() {
+    const ThreadScratch& S{ t_Scratch };
+    return { S.Base, S.Offset };
+}
+
+void
+RewindScratch(const ScratchMarker& Marker) {
+    ThreadScratch& S{ t_Scratch };
+
+    // A marker taken before the first allocation has no block yet
+    if (Marker.Block && Marker.Block != S.Base) UNLIKELY {
+        LOG_ERROR("Scratch marker rewound on a different thread!");
+        return;
+    }
+
+    if (Marker.Offset > S.Offset) UNLIKELY {
+        LOG_ERROR("Scratch marker rewound out of order!");
+        return;
+    }
+
+    S.Offset = Marker.Offset;
+}
+}
@@ -0,0 +1,62 @@
+#include <Iron.Core/Task.h>
+
+#include <Windows.h>
+
+namespace Iron::Detail {
+namespace {
+struct EventWait {
+    HANDLE      Event;
+    void*       Coroutine;
+};
+
+// Runs on the OS thread pool, only hands the coroutine over to the job system
+void CALLBACK
+OnEventSignaled(PTP_CALLBACK_INSTANCE, PVOID Context, PTP_WAIT Wait, TP_WAIT_RESULT) {
+    EventWait* W{ (EventWait*)Context };
+    void* const Coroutine{ W->Coroutine };
+
+    CloseHandle(W->Event);
+    MemFree(W);
+    CloseThreadpoolWait(Wait);
+
+    RunJob(&ResumeCoroutineJob, Coroutine, nullptr, JobPriority::High);
+}
+} // anonymous namespace
+
+void
+ResumeCoroutineJob(void* Address) {
+    std::coroutine_handle<>::from_address(Address).resume();
+}
+
+void*
+CreateTaskEvent() {
+    return CreateEventA(nullptr, FALSE, FALSE, nullptr);
+}
+
+void
+CloseTaskEvent(void* Event) {
+    if (Event) {
+        CloseHandle(Event);
+    }
+}
+
+bool
+ResumeOnEvent(void* Event, void* Coroutine) {
+    EventWait* W{ (EventWait*)MemAlloc(sizeof(EventWait)) };
+    if (!W) {
+        return false;
+    }
+
+    W->Event = Event;
+    W->Coroutine = Coroutine;
+
+    PTP_WAIT Wait{ CreateThreadpoolWait(&OnEventSignaled, W, nullptr) };
+    if (!Wait) {
+        MemFree(W);
+        return false;
+    }
+
+    SetThreadpoolWait(Wait, Event, nullptr);
+    return true;
+}
+}
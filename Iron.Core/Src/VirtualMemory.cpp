@@ -0,0 +1,63 @@
+#include <Iron.Core/Core.h>
+
+#include <Windows.h>
+
+namespace Iron {
+namespace {
+u64
+QueryPageSize() {
+    SYSTEM_INFO Info{};
+    GetSystemInfo(&Info);
+    return Info.dwPageSize;
+}
+} // anonymous namespace
+
+void*
+VirtualReserve(u64 Size) {
+    if (!Size) {
+        return nullptr;
+    }
+
+    void* Address{ VirtualAlloc(nullptr, (SIZE_T)Size, MEM_RESERVE, PAGE_NOACCESS) };
+    if (!Address) {
+        LOG_ERROR("Failed to reserve %llu bytes of address space, error %lu", Size, GetLastError());
+    }
+
+    return Address;
+}
+
+bool
+VirtualCommit(void* Address, u64 Size) {
+    if (!Size) {
+        return true;
+    }
+
+    if (!VirtualAlloc(Address, (SIZE_T)Size, MEM_COMMIT, PAGE_READWRITE)) {
+        LOG_ERROR("Failed to commit %llu bytes, error %lu", Size, GetLastError());
+        return false;
+    }
+
+    return true;
+}
+
+void
+VirtualDecommit(void* Address, u64 Size) {
+    if (Address && Size) {
+        VirtualFree(Address, (SIZE_T)Size, MEM_DECOMMIT);
+    }
+}
+
+void
+VirtualRelease(void* Address, u64) {
+    // The whole reservation is released at once, the size is only needed by mmap based platforms
+    if (Address) {
+        VirtualFree(Address, 0, MEM_RELEASE);
+    }
+}
+
+u64
+GetVirtualPageSize() {
+    static const u64 PageSize{ QueryPageSize() };
+    return PageSize;
+}
+}
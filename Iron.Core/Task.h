@@ -0,0 +1,532 @@
+#pragma once
+#include <Iron.Core/Concurrent.h>
+
+#include <coroutine>
+#include <exception>
+
+// Coroutine tasks resumed by the job system. A Task does nothing until it is awaited,
+// passed to WhenAll/SyncWait or spawned, and it resumes its awaiter on whichever thread
+// finished it. Use SwitchToWorker() to move the rest of a coroutine onto a job thread.
+namespace Iron {
+template<typename T = void>
+class Task;
+
+struct FileReadResult {
+    Result::Code    Code;
+    u8*             Data;       // Owned by the caller, release with MemFree
+    u64             Length;
+};
+
+namespace Detail {
+CORE_API void ResumeCoroutineJob(void* Address);
+
+/// Resumes the coroutine on a job thread once Event is signaled, then closes Event.
+/// Returns false if the wait could not be registered, the caller must block instead.
+CORE_API bool ResumeOnEvent(void* Event, void* Coroutine);
+CORE_API void* CreateTaskEvent();
+CORE_API void CloseTaskEvent(void* Event);
+
+struct TaskPromiseBase {
+    std::coroutine_handle<>     Continuation{};
+    std::exception_ptr          Exception{};
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+
+        template<typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> Handle) noexcept {
+            const std::coroutine_handle<> Next{ Handle.promise().Continuation };
+            return Next ? Next : std::noop_coroutine();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() noexcept { Exception = std::current_exception(); }
+};
+
+template<typename T>
+struct TaskPromise : TaskPromiseBase {
+    alignas(T) u8   Storage[sizeof(T)];
+    bool            HasValue{};
+
+    ~TaskPromise() {
+        if (HasValue) {
+            ((T*)Storage)->~T();
+        }
+    }
+
+    Task<T> get_return_object() noexcept;
+
+    template<typename U>
+    void return_value(U&& Value) {
+        new (Storage) T(static_cast<U&&>(Value));
+        HasValue = true;
+    }
+
+    T& Result() {
+        if (Exception) {
+            std::rethrow_exception(Exception);
+        }
+
+        return *(T*)Storage;
+    }
+};
+
+template<>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object() noexcept;
+
+    void return_void() noexcept {}
+
+    void Result() {
+        if (Exception) {
+            std::rethrow_exception(Exception);
+        }
+    }
+};
+}
+
+template<typename T>
+class Task {
+public:
+    using promise_type = Detail::TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() = default;
+    explicit Task(Handle H) : m_Handle(H) {}
+
+    Task(Task&& Other) noexcept : m_Handle(Other.m_Handle) {
+        Other.m_Handle = {};
+    }
+
+    Task& operator=(Task&& Other) noexcept {
+        if (this != &Other) {
+            Destroy();
+            m_Handle = Other.m_Handle;
+            Other.m_Handle = {};
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        Destroy();
+    }
+
+    bool IsValid() const { return (bool)m_Handle; }
+    bool IsDone() const { return !m_Handle || m_Handle.done(); }
+
+    //Only valid once the task is done, rethrows an exception that escaped the coroutine
+    decltype(auto) Result() { return m_Handle.promise().Result(); }
+
+    //Runs the task and returns its result
+    auto operator co_await() noexcept {
+        struct Awaiter {
+            Handle  H;
+
+            bool await_ready() const noexcept { return !H || H.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> Awaiting) noexcept {
+                H.promise().Continuation = Awaiting;
+                return H;
+            }
+
+            auto await_resume() {
+                if constexpr (std::is_void_v<T>) {
+                    H.promise().Result();
+                }
+                else {
+                    return Move(H.promise().Result());
+                }
+            }
+        };
+
+        return Awaiter{ m_Handle };
+    }
+
+    //Runs the task without fetching its result, used by WhenAll and SyncWait
+    auto WhenReady() noexcept {
+        struct Awaiter {
+            Handle  H;
+
+            bool await_ready() const noexcept { return !H || H.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> Awaiting) noexcept {
+                H.promise().Continuation = Awaiting;
+                return H;
+            }
+
+            void await_resume() noexcept {}
+        };
+
+        return Awaiter{ m_Handle };
+    }
+
+private:
+    Handle  m_Handle{};
+
+    void Destroy() {
+        if (m_Handle) {
+            m_Handle.destroy();
+            m_Handle = {};
+        }
+    }
+};
+
+namespace Detail {
+template<typename T>
+inline Task<T>
+TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>{ std::coroutine_handle<TaskPromise<T>>::from_promise(*this) };
+}
+
+inline Task<void>
+TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>{ std::coroutine_handle<TaskPromise<void>>::from_promise(*this) };
+}
+
+//Coroutine that signals a counter once it is suspended at its end, so the waiter
+//can destroy it as soon as it sees the counter reach zero.
+struct SignalTask {
+    struct promise_type {
+        JobCounter*     Counter{};
+
+        SignalTask get_return_object() noexcept {
+            return { std::coroutine_handle<promise_type>::from_promise(*this) };
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        auto final_suspend() noexcept {
+            struct Awaiter {
+                bool await_ready() noexcept { return false; }
+
+                void await_suspend(std::coroutine_handle<promise_type> H) noexcept {
+                    H.promise().Counter->Value.fetch_sub(1, std::memory_order_release);
+                }
+
+                void await_resume() noexcept {}
+            };
+
+            return Awaiter{};
+        }
+
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type>     H;
+};
+
+template<typename A>
+SignalTask
+MakeSignalTask(A& Awaitable) {
+    co_await static_cast<A&&>(Awaitable);
+}
+
+//Shared by the items of one WhenAll, the last one to finish resumes the parent
+struct WhenAllState {
+    std::atomic<u32>            Remaining{};
+    std::coroutine_handle<>     Parent{};
+};
+
+struct WhenAllItem {
+    struct promise_type {
+        WhenAllState*   State{};
+
+        WhenAllItem get_return_object() noexcept {
+            return { std::coroutine_handle<promise_type>::from_promise(*this) };
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        auto final_suspend() noexcept {
+            struct Awaiter {
+                bool await_ready() noexcept { return false; }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> H) noexcept {
+                    WhenAllState* State{ H.promise().State };
+                    if (State->Remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        return State->Parent;
+                    }
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() noexcept {}
+            };
+
+            return Awaiter{};
+        }
+
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type>     H;
+};
+
+template<typename T>
+WhenAllItem
+MakeWhenAllItem(Task<T>& Source) {
+    co_await Source.WhenReady();
+}
+
+class WhenAllAwaiter {
+public:
+    explicit WhenAllAwaiter(u32 Count) {
+        m_Items.Reserve(Count);
+    }
+
+    //Only valid before the awaiter is suspended, items find the state when they start
+    WhenAllAwaiter(WhenAllAwaiter&& Other) noexcept
+        : m_Items(Move(Other.m_Items)) {
+    }
+
+    ~WhenAllAwaiter() {
+        for (WhenAllItem& Item : m_Items) {
+            Item.H.destroy();
+        }
+    }
+
+    template<typename T>
+    void Add(Task<T>& Source) {
+        m_Items.PushBack(MakeWhenAllItem(Source));
+    }
+
+    bool await_ready() const noexcept { return m_Items.Empty(); }
+
+    //Items start on job threads, the extra count keeps the parent from being
+    //resumed before every item has been queued
+    bool await_suspend(std::coroutine_handle<> Parent) noexcept {
+        m_State.Parent = Parent;
+        m_State.Remaining.store(m_Items.Size() + 1, std::memory_order_relaxed);
+
+        for (WhenAllItem& Item : m_Items) {
+            Item.H.promise().State = &m_State;
+        }
+
+        for (WhenAllItem& Item : m_Items) {
+            RunJob(&ResumeCoroutineJob, Item.H.address());
+        }
+
+        return m_State.Remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+
+    void await_resume() noexcept {}
+
+private:
+    Vector<WhenAllItem>     m_Items{};
+    WhenAllState            m_State{};
+};
+}
+
+/// Continues the awaiting coroutine on a job thread
+inline auto
+SwitchToWorker(JobPriority::Priority Priority = JobPriority::Normal) noexcept {
+    struct Awaiter {
+        JobPriority::Priority   Priority;
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> H) noexcept {
+            RunJob(&Detail::ResumeCoroutineJob, H.address(), nullptr, Priority);
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    return Awaiter{ Priority };
+}
+
+/// Reads through the IO queue without occupying a thread, the awaiter continues on a job
+/// thread. Info's callback and user data are replaced.
+inline auto
+AwaitRead(const IoReadInfo& Info) noexcept {
+    struct Awaiter {
+        IoReadInfo              Info;
+        IoCompletion            Completion{};
+        std::coroutine_handle<> H{};
+
+        bool await_ready() const noexcept { return false; }
+
+        bool await_suspend(std::coroutine_handle<> Awaiting) noexcept {
+            H = Awaiting;
+            Info.Callback = &Done;
+            Info.UserData = this;
+            if (!SubmitRead(Info)) {
+                Completion.Code = Result::ENotInitialized;
+                return false;
+            }
+            return true;
+        }
+
+        IoCompletion await_resume() noexcept { return Completion; }
+
+        static void Done(const IoCompletion& Completion) {
+            Awaiter& Self{ *(Awaiter*)Completion.UserData };
+            Self.Completion = Completion;
+            RunJob(&Detail::ResumeCoroutineJob, Self.H.address(), nullptr, JobPriority::High);
+        }
+    };
+
+    return Awaiter{ Info };
+}
+
+/// Reads a whole file through the IO queue, or on a job thread while the queue isn't running.
+/// The awaiter continues on a job thread.
+inline auto
+AwaitReadFile(const char* Path) noexcept {
+    struct Awaiter {
+        const char*             Path;
+        FileReadResult          Read{};
+        std::coroutine_handle<> H{};
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> Awaiting) noexcept {
+            H = Awaiting;
+
+            IoReadInfo Info{};
+            Info.Path = Path;
+            Info.Callback = &Done;
+            Info.UserData = this;
+            Info.Priority = IoPriority::High;
+            if (!SubmitRead(Info)) {
+                RunJob(&Run, this, nullptr, JobPriority::High);
+            }
+        }
+
+        FileReadResult await_resume() noexcept { return Read; }
+
+        static void Done(const IoCompletion& Completion) {
+            Awaiter& Self{ *(Awaiter*)Completion.UserData };
+            Self.Read = { Completion.Code, Completion.Buffer, Completion.Bytes };
+            RunJob(&Detail::ResumeCoroutineJob, Self.H.address(), nullptr, JobPriority::High);
+        }
+
+        static void Run(void* Data) {
+            Awaiter& Self{ *(Awaiter*)Data };
+            Self.Read.Code = ReadFile(Self.Path, Self.Read.Data, Self.Read.Length);
+            Self.H.resume();
+        }
+    };
+
+    return Awaiter{ Path };
+}
+
+/// Waits until Fence reaches Value without blocking a thread. FenceT follows the
+/// ID3D12Fence interface: GetCompletedValue() and SetEventOnCompletion(Value, Event).
+template<typename FenceT>
+auto
+AwaitFence(FenceT* Fence, u64 Value) noexcept {
+    struct Awaiter {
+        FenceT*     Fence;
+        u64         Value;
+
+        bool await_ready() const noexcept { return Fence->GetCompletedValue() >= Value; }
+
+        // SetEventOnCompletion returns an HRESULT, negative on failure. An event that will never
+        // be signaled would leave the coroutine suspended forever, so it resumes inline instead.
+        bool await_suspend(std::coroutine_handle<> H) noexcept {
+            void* Event{ Detail::CreateTaskEvent() };
+            if (Event) {
+                if (Fence->SetEventOnCompletion(Value, Event) >= 0 && Detail::ResumeOnEvent(Event, H.address())) {
+                    return true;
+                }
+                Detail::CloseTaskEvent(Event);
+            }
+
+            // A null event makes the fence block until the value is reached
+            if (Fence->SetEventOnCompletion(Value, nullptr) < 0) {
+                LOG_ERROR("Failed to wait for fence value %llu, resuming without it", Value);
+            }
+            return false;
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    return Awaiter{ Fence, Value };
+}
+
+/// Runs all tasks concurrently on the job threads, results stay in the tasks
+template<typename... Ts>
+Detail::WhenAllAwaiter
+WhenAll(Task<Ts>&... Tasks) {
+    Detail::WhenAllAwaiter Awaiter{ (u32)sizeof...(Ts) };
+    (Awaiter.Add(Tasks), ...);
+    return Awaiter;
+}
+
+template<typename T>
+Detail::WhenAllAwaiter
+WhenAll(Vector<Task<T>>& Tasks) {
+    Detail::WhenAllAwaiter Awaiter{ Tasks.Size() };
+    for (Task<T>& Source : Tasks) {
+        Awaiter.Add(Source);
+    }
+    return Awaiter;
+}
+
+/// Blocks until the awaitable completes, the calling thread runs jobs meanwhile
+template<typename A>
+void
+SyncWait(A&& Awaitable) {
+    JobCounter Counter{};
+    Counter.Value.store(1, std::memory_order_relaxed);
+
+    Detail::SignalTask Signal{ Detail::MakeSignalTask(Awaitable) };
+    Signal.H.promise().Counter = &Counter;
+    Signal.H.resume();
+
+    WaitForCounter(&Counter);
+    Signal.H.destroy();
+}
+
+template<typename T>
+decltype(auto)
+SyncWait(Task<T>& Source) {
+    SyncWait(Source.WhenReady());
+    return Source.Result();
+}
+
+namespace Detail {
+//Owns a spawned task, both frames are freed when the task finishes
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+
+        // Nobody awaits a spawned task, so the exception can't be handed on
+        void unhandled_exception() noexcept {
+            LOG_FATAL("Unhandled exception in a spawned task");
+            std::terminate();
+        }
+    };
+};
+
+inline DetachedTask
+RunDetached(Task<void> Source) {
+    co_await Source;
+}
+}
+
+/// Starts a task nobody awaits
+inline void
+Spawn(Task<void>&& Source) {
+    Detail::RunDetached(Move(Source));
+}
+
+/// Reads a whole file through the IO queue
+inline Task<FileReadResult>
+ReadFileAsync(const char* Path) {
+    co_return co_await AwaitReadFile(Path);
+}
+}
@@ -1,6 +1,10 @@
 #include <Iron.Engine/Src/EngineContext.h>
+#include <Iron.Core/CVar.h>
+#include <Iron.Core/Concurrent.h>
 
 #include <Windows.h>
+#include <stdio.h>
+#include <string.h>
 
 namespace Iron {
 namespace {
@@ -13,6 +17,44 @@ constexpr static const char* g_ModuleNames[EngineAPI::Count]{
     "Iron.Filesystem.dll"
 };
 
+constexpr static const char* g_LogLevelNames[LogLevel::Count]{
+    "debug",
+    "info",
+    "warning",
+    "error",
+    "fatal",
+};
+
+constexpr static u32 g_FramesInFlight{ 3 };
+constexpr static u64 g_FrameArenaBlockSize{ 4ull * 1024 * 1024 };
+
+CVar<s32> g_IoFrameBudgetKb{ "engine", "io_frame_budget_kb", 0,
+    "File data read per frame below critical priority in KB, 0 is unlimited" };
+
+// Applied as soon as they change, also by a settings.ini reload
+CVar<bool> g_LogEnable[LogLevel::Count]{
+    { "engine.log", "enable_debug", true, "Log debug messages" },
+    { "engine.log", "enable_info", true, "Log info messages" },
+    { "engine.log", "enable_warning", true, "Log warnings" },
+    { "engine.log", "enable_error", true, "Log errors" },
+    { "engine.log", "enable_fatal", true, "Log fatal errors" },
+};
+CVar<bool> g_LogEnableFilename{ "engine.log", "enable_filename", true,
+    "Start log lines with the file and line of the call" };
+
+// The sinks are created once at startup. Their paths and levels are strings, so they are
+// read straight from settings.ini: binary_file, file, console_level, file_level, ring_level.
+CVar<bool> g_LogConsole{ "engine.log", "console", true,
+    "Write the log to the console", CVarFlags::ReadOnly };
+CVar<s32> g_LogFileMaxMb{ "engine.log", "file_max_mb", 16,
+    "Size in MB at which the log file is rotated, 0 disables it", CVarFlags::ReadOnly };
+CVar<s32> g_LogFileMaxSeconds{ "engine.log", "file_max_seconds", 0,
+    "Age in seconds at which the log file is rotated, 0 disables it", CVarFlags::ReadOnly };
+CVar<s32> g_LogFileKeep{ "engine.log", "file_keep", 4,
+    "Rotated log files kept", CVarFlags::ReadOnly };
+CVar<s32> g_LogRingMessages{ "engine.log", "ring_messages", 256,
+    "Recent messages kept in memory for crash reports, 0 disables the ring", CVarFlags::ReadOnly };
+
 std::filesystem::path
 GetExePath()
 {
@@ -21,63 +63,121 @@ GetExePath()
     if (!Length || GetLastError() == ERROR_INSUFFICIENT_BUFFER) return {};
     return std::filesystem::path(Path).remove_filename();
 }
+
+void
+OnLogLevelChanged(CVarBase& Var, void* UserData)
+{
+    EnableLogLevel((LogLevel::Level)(size_t)UserData, ((CVar<bool>&)Var).Get());
+}
+
+void
+OnLogFilenameChanged(CVarBase& Var, void*)
+{
+    EnableLogIncludePath(((CVar<bool>&)Var).Get());
+}
+
+void
+OnSettingChanged(const char* Section, const char* Keyword, const char* Value, void*)
+{
+    char Name[128];
+    snprintf(Name, sizeof(Name), "%s.%s", Section, Keyword);
+
+    CVarBase* const Var{ FindCVar(Name) };
+    if (!Var) {
+        // The log settings that are not CVars are only read at startup
+        if (!strcmp(Section, "engine.log")) {
+            LOG_INFO("%s=%s applies after a restart", Name, Value);
+        }
+        return;
+    }
+
+    if (Var->GetFlags() & CVarFlags::ReadOnly) {
+        LOG_INFO("%s=%s applies after a restart", Name, Value);
+    }
+    else if (Var->SetFromString(Value)) {
+        LOG_INFO("%s=%s", Name, Value);
+    }
+    else {
+        LOG_WARNING("Invalid value %s for %s", Value, Name);
+    }
+}
+
+// Runs on the main thread between frames
+void
+OnSettingsFileChanged(const char* Path, void* UserData)
+{
+    EngineContext* const Context{ (EngineContext*)UserData };
+    if (Result::Fail(Context->m_Settings.Reload(Path, &OnSettingChanged))) {
+        LOG_WARNING("Failed to reload %s", Path);
+        return;
+    }
+
+    Context->m_SettingsAsRead.Merge(Context->m_Settings);
+}
+
+// Accepts the level name or its number
+LogLevel::Level
+ParseLogLevel(const char* Value, LogLevel::Level Default)
+{
+    for (u32 I{ 0 }; I < LogLevel::Count; ++I) {
+        if (!_stricmp(Value, g_LogLevelNames[I])) {
+            return (LogLevel::Level)I;
+        }
+    }
+
+    if (Value[0] >= '0' && Value[0] <= '9') {
+        const u32 Level{ (u32)atoi(Value) };
+        return Level < LogLevel::Count ? (LogLevel::Level)Level : Default;
+    }
+
+    return Default;
+}
 } // anonymous namespace
 
 EngineContext g_Context{};
 
 EngineContext::EngineContext()
     :
-    m_LogEnableDebug(true),
-    m_LogEnableInfo(true),
-    m_LogEnableWarning(true),
-    m_LogEnableError(true),
-    m_LogEnableFatal(true),
-    m_LogEnableFilename(true),
     m_Headless(true),
     m_Running(false)
 {
     m_EngineDir = GetExePath();
 
-    std::filesystem::path ConfigPath{ "D:\\code\\IronEngine\\" };
-    ConfigPath.append("settings.ini");
-    ConfigFile Config{};
-    if (Result::Success(Config.Load(ConfigPath.string().c_str()))) {
-        m_LogEnableDebug = atoi(Config.Get("engine.log", "enable_debug", "1"));
-        m_LogEnableInfo = atoi(Config.Get("engine.log", "enable_info", "1"));
-        m_LogEnableWarning = atoi(Config.Get("engine.log", "enable_warning", "1"));
-        m_LogEnableError = atoi(Config.Get("engine.log", "enable_error", "1"));
-        m_LogEnableFatal = atoi(Config.Get("engine.log", "enable_fatal", "1"));
-        m_LogEnableFilename = atoi(Config.Get("engine.log", "enable_filename", "1"));
-    }
-
-    EnableLogLevel(LogLevel::Debug, m_LogEnableDebug);
-    EnableLogLevel(LogLevel::Info, m_LogEnableInfo);
-    EnableLogLevel(LogLevel::Warning, m_LogEnableWarning);
-    EnableLogLevel(LogLevel::Error, m_LogEnableError);
-    EnableLogLevel(LogLevel::Fatal, m_LogEnableFatal);
-    EnableLogIncludePath(m_LogEnableFilename);
+    m_SettingsPath = "D:\\code\\IronEngine\\";
+    m_SettingsPath.append("settings.ini");
+    if (Result::Success(m_Settings.Load(m_SettingsPath.string().c_str()))) {
+        m_SettingsAsRead.Merge(m_Settings);
+        BindCVarConfig(&m_Settings);
+    }
+
+    for (u32 I{ 0 }; I < LogLevel::Count; ++I) {
+        EnableLogLevel((LogLevel::Level)I, g_LogEnable[I]);
+        g_LogEnable[I].AddCallback(&OnLogLevelChanged, (void*)(size_t)I);
+    }
+    EnableLogIncludePath(g_LogEnableFilename);
+    g_LogEnableFilename.AddCallback(&OnLogFilenameChanged);
+
+    AddLogSinks();
 }
 
 EngineContext::~EngineContext() {
     SafeRelease(m_RenderContext);
 
-    std::filesystem::path ConfigPath{ "D:\\code\\IronEngine\\" };
-    ConfigPath.append("settings.ini");
-    ConfigFile Config{};
-    Config.Load(ConfigPath.string().c_str());
-
-    Config.Set("engine.log", "enable_debug", std::to_string(m_LogEnableDebug).c_str());
-    Config.Set("engine.log", "enable_info", std::to_string(m_LogEnableInfo).c_str());
-    Config.Set("engine.log", "enable_warning", std::to_string(m_LogEnableWarning).c_str());
-    Config.Set("engine.log", "enable_error", std::to_string(m_LogEnableError).c_str());
-    Config.Set("engine.log", "enable_fatal", std::to_string(m_LogEnableFatal).c_str());
-    Config.Set("engine.log", "enable_filename", std::to_string(m_LogEnableFilename).c_str());
-
-    if (Result::Fail(Config.Save(ConfigPath.string().c_str()))) {
+    // settings.ini may have been edited since it was last read, so only the values changed
+    // here are written, over a fresh copy of the file
+    SaveCVars(m_Settings);
+    if (Result::Fail(m_Settings.SaveChanges(m_SettingsPath.string().c_str(), m_SettingsAsRead))) {
         LOG_ERROR("Failed to save engine config settings!");
     }
 
+    // Freed here so the leak report below doesn't list them
+    BindCVarConfig(nullptr);
+    m_SettingsAsRead.Clear();
+    m_Settings.Clear();
+
     Reset();
+
+    ReportMemoryLeaks();
 }
 
 Result::Code
@@ -91,7 +191,35 @@ EngineContext::Run(const EngineInitInfo& Info, Application* const App)
         return Result::ENoInterface;
     }
 
-    Result::Code Res{ Result::Ok };
+    Result::Code Res{ StartLogWriter() };
+    if (Result::Fail(Res)) {
+        LOG_ERROR("Failed to start the log writer, logging synchronously");
+    }
+
+    const char* const BinaryFile{ m_Settings.Get("engine.log", "binary_file", "") };
+    if (*BinaryFile) {
+        Res = OpenBinaryLog(BinaryFile);
+        if (Result::Fail(Res)) {
+            LOG_ERROR("Failed to open binary log %s", BinaryFile);
+        }
+    }
+
+    Res = InitializeJobSystem();
+    if (Result::Fail(Res)) {
+        LOG_FATAL("Failed to start the job system!");
+        return Res;
+    }
+
+    Res = StartIoQueue();
+    if (Result::Fail(Res)) {
+        LOG_FATAL("Failed to start the IO queue!");
+        return Res;
+    }
+
+    if (!WatchFile(m_SettingsPath.string().c_str(), &OnSettingsFileChanged, this)) {
+        LOG_WARNING("Changes to %s need a restart", m_SettingsPath.string().c_str());
+    }
+
     m_RenderContext = new RenderContext(LoadAndGetFactory(
         g_ModuleNames[EngineAPI::Renderer]));
     if (!m_RenderContext) {
@@ -137,9 +265,21 @@ EngineContext::Run(const EngineInitInfo& Info, Application* const App)
         return Res;
     }
 
+    Res = GetFrameArena().Initialize(g_FramesInFlight, g_FrameArenaBlockSize);
+    if (Result::Fail(Res)) {
+        LOG_FATAL("Failed to initialize the frame arena!");
+        App->Shutdown();
+        return Res;
+    }
+
     m_Running = true;
 
     while (m_Running.load()) {
+        GetFrameArena().BeginFrame(m_FrameNumber);
+
+        BeginIoFrame((u64)Math::Max(g_IoFrameBudgetKb.Get(), 0) * 1024);
+        DispatchFileChanges();
+
         App->Frame();
 
         m_MainWindow->PumpMessages();
@@ -166,6 +306,17 @@ EngineContext::Run(const EngineInitInfo& Info, Application* const App)
 
     SafeRelease(m_RenderContext);
 
+    GetFrameArena().Release();
+
+    StopIoQueue();
+    StopFileWatcher();
+    ShutdownJobSystem();
+    CloseBinaryLog();
+    StopLogWriter();
+
+    // Variables of other modules may be gone by the time the context is destroyed
+    SaveCVars(m_Settings);
+
     return Result::Ok;
 }
 
@@ -215,8 +366,44 @@ EngineContext::ParseCommandArgs(s32 ArgC, char** ArgV) {
     }
 }
 
+void
+EngineContext::AddLogSinks() {
+    if (g_LogConsole) {
+        const LogLevel::Level Level{ ParseLogLevel(m_Settings.Get("engine.log", "console_level", "debug"), LogLevel::Debug) };
+        AddLogSink(CreateConsoleLogSink(), Level);
+    }
+
+    const char* const File{ m_Settings.Get("engine.log", "file", "") };
+    if (*File) {
+        const LogLevel::Level Level{ ParseLogLevel(m_Settings.Get("engine.log", "file_level", "debug"), LogLevel::Debug) };
+        const LogFileRotation Rotation{ (u64)Math::Max(g_LogFileMaxMb.Get(), 0) * 1024 * 1024,
+            (u32)Math::Max(g_LogFileMaxSeconds.Get(), 0), (u32)Math::Max(g_LogFileKeep.Get(), 0) };
+        if (Result::Fail(AddLogSink(CreateFileLogSink(File, Rotation), Level))) {
+            LOG_ERROR("Failed to open log file %s", File);
+        }
+    }
+
+    if (g_LogRingMessages > 0) {
+        // Crash reports need the recent messages also while they go to the binary log
+        const LogLevel::Level Level{ ParseLogLevel(m_Settings.Get("engine.log", "ring_level", "info"), LogLevel::Info) };
+        m_LogRing = CreateRingLogSink((u32)g_LogRingMessages.Get());
+        if (Result::Fail(AddLogSink(m_LogRing, Level, LogSinkFlags::KeepWithBinaryLog))) {
+            m_LogRing = nullptr;
+        }
+    }
+}
+
 void
 EngineContext::Reset() {
+    // Jobs may still reference module code
+    StopIoQueue();
+    StopFileWatcher();
+    ShutdownJobSystem();
+    CloseBinaryLog();
+    StopLogWriter();
+    RemoveAllLogSinks();
+    m_LogRing = nullptr;
+
     for (u32 I{ 0 }; I < EngineAPI::Count; ++I) {
         m_Modules.UnloadModule(Fnv1A(g_ModuleNames[I]));
     }
@@ -23,6 +23,12 @@ public:
 
     std::filesystem::path       m_EngineDir{};
 
+    // settings.ini, parsed once, CVars are bound to it
+    std::filesystem::path       m_SettingsPath{};
+    ConfigFile                  m_Settings{};
+    // settings.ini as last loaded or reloaded, shutdown saves only what differs from it
+    ConfigFile                  m_SettingsAsRead{};
+
     Window::IWindowFactory*     m_WindowFactory{};
     Window::IWindow*            m_MainWindow{};
 
@@ -38,14 +44,12 @@ public:
 
     void Reset();
 
+private:
+    void AddLogSinks();
+
 public:
-    // Log config
-    bool m_LogEnableDebug : 1;
-    bool m_LogEnableInfo : 1;
-    bool m_LogEnableWarning : 1;
-    bool m_LogEnableError : 1;
-    bool m_LogEnableFatal : 1;
-    bool m_LogEnableFilename : 1;
+    // Log config lives in the engine.log CVars and settings
+    ILogRingSink* m_LogRing{};      // Owned by the log
 
     // Disable windowing and rendering
     bool m_Headless : 1;
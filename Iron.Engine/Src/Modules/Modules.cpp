@@ -12,8 +12,7 @@ ModuleManager::~ModuleManager() {
 
 Result::Code
 ModuleManager::LoadModule(const char* Path, u64 Id) {
-    auto Pair{ m_Modules.find(Id) };
-    if (Pair != m_Modules.end()) {
+    if (m_Modules.Contains(Id)) {
         return Result::Ok;
     }
 
@@ -38,31 +37,30 @@ ModuleManager::LoadModule(const char* Path, u64 Id) {
     }
 
     LOG_INFO("Loaded module with factory %s Id=%ull", Path, Id);
-    m_Modules[Id] = Mod;
+    m_Modules.Emplace(Id, Mod);
 
     return Res;
 }
 
 void ModuleManager::UnloadModule(u64 Id) {
-    auto It{ m_Modules.find(Id) };
-    if (It == m_Modules.end())
+    EngineModule* Mod{ m_Modules.Find(Id) };
+    if (!Mod)
         return;
 
-    EngineModule& Mod{ It->second };
-    if (EngineModule::IsLoaded(Mod)) {
-        SafeRelease(Mod.Factory);
-        FreeLibrary((HMODULE)Mod.Library);
+    if (EngineModule::IsLoaded(*Mod)) {
+        SafeRelease(Mod->Factory);
+        FreeLibrary((HMODULE)Mod->Library);
     }
 
-    m_Modules.erase(It);
+    m_Modules.Erase(Id);
 }
 
 IObjectBase* const
 ModuleManager::GetFactory(u64 Id) const
 {
-    auto Pair{ m_Modules.find(Id) };
-    if (Pair != m_Modules.end()) {
-        return Pair->second.Factory;
+    const EngineModule* Mod{ m_Modules.Find(Id) };
+    if (Mod) {
+        return Mod->Factory;
     }
 
     return nullptr;
@@ -70,17 +68,19 @@ ModuleManager::GetFactory(u64 Id) const
 
 void
 ModuleManager::Reset() {
-    for (auto It{ m_Modules.begin() }; It != m_Modules.end(); ) {
-        if (EngineModule::IsLoaded(It->second)) {
-            LOG_WARNING("Dll Id=%ull was not unloaded!", It->second.Id);
-            SafeRelease(It->second.Factory);
-            FreeLibrary((HMODULE)It->second.Library);
-
-            It = m_Modules.erase(It);
+    m_Modules.EraseIf([](HashMap<u64, EngineModule>::Pair& It) {
+        if (!EngineModule::IsLoaded(It.Value)) {
+            return false;
         }
-        else {
-            ++It;
-        }
-    }
+
+        LOG_WARNING("Dll Id=%ull was not unloaded!", It.Value.Id);
+        SafeRelease(It.Value.Factory);
+        FreeLibrary((HMODULE)It.Value.Library);
+
+        return true;
+    });
+
+    // Frees the table too, the engine reports leaks right after
+    m_Modules = {};
 }
 }
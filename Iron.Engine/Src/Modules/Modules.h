@@ -1,7 +1,6 @@
 #pragma once
 #include <Iron.Engine/Engine.h>
 
-#include <unordered_map>
 #include <string>
 
 namespace Iron {
@@ -42,6 +41,6 @@ public:
     void Reset();
 
 private:
-    std::unordered_map<u64, EngineModule> m_Modules{};
+    HashMap<u64, EngineModule> m_Modules{};
 };
 }
@@ -14,15 +14,14 @@ BuildPipelineFromJson(
     (void*)device;
     (void*)pipeline;
     Result::Code res{ Result::Ok };
-    u8* blob{};
-    u64 length{};
-    res = ReadFile(path, blob, length);
+    MappedFile file{};
+    res = file.Open(path, FileAccess::Sequential);
     if (Result::Fail(res)) {
         return res;
     }
 
     try {
-        json data = json::parse((char*)blob);
+        json data = json::parse(file.Data(), file.Data() + file.Size());
         
 
     }
@@ -33,8 +32,6 @@ BuildPipelineFromJson(
         LOG_ERROR("Json missing key: %s", e.what());
     }
 
-    MemFree(blob);
-
     return Result::Ok;
 }
 }
@@ -1,6 +1,7 @@
 #include <Iron.Engine/Src/Renderer/Renderer.h>
-
-#include <filesystem>
+#include <Iron.Core/CVar.h>
+#include <Iron.Core/Task.h>
+#include <Iron.FileSystem/FileSystem.h>
 
 using namespace Iron::RHI;
 
@@ -8,11 +9,43 @@ using namespace Iron::RHI;
 
 namespace Iron {
 namespace {
+// Device settings are only read when the device is created
+CVar<bool> g_ForceLegacy{ "renderer", "force_legacy", false,
+    "Create a D3D11 device instead of D3D12", CVarFlags::ReadOnly };
+CVar<bool> g_DebugDevice{ "renderer", "debug_device", false,
+    "Enable the graphics API debug layer", CVarFlags::ReadOnly };
+CVar<bool> g_DisableGpuTimeout{ "renderer", "disable_gpu_timeout", false,
+    "Disable the GPU timeout detection", CVarFlags::ReadOnly };
+CVar<s32> g_MaxShaderResources{ "renderer", "max_shader_resources", 2048,
+    "Shader visible descriptors", CVarFlags::ReadOnly };
+
+// Applied whenever a surface is created
+CVar<bool> g_AllowTearing{ "renderer", "allow_tearing", false,
+    "Present without waiting for vblank when the display allows it" };
+CVar<bool> g_TripleBuffer{ "renderer", "triple_buffer", true,
+    "Use three swap chain buffers instead of two" };
+
 RHIPipelineLayout   layout{};
 RHIPipeline         pso{};
 RHIResource         g_ShaderDataBuffer{};
 RHIResource         g_Positions{};
 
+// Mapped instead of read, PSO creation reads the bytecode straight from the file cache
+Task<Result::Code>
+LoadShader(const char* Path, MappedFile& File, FS::ShaderAsset& Shader) {
+    Result::Code Res{ File.Open(Path, FileAccess::Sequential) };
+    if (Result::Fail(Res)) {
+        co_return Res;
+    }
+
+    Res = ReadSerialized(File.Data(), File.Size(), Shader);
+    if (Result::Fail(Res)) {
+        LOG_ERROR("Invalid shader file %s, rebuild it with the editor", Path);
+    }
+
+    co_return Res;
+}
+
 void
 RenderStuff(RHIGraphicsCommandList& ctx) {
 }
@@ -155,23 +188,11 @@ RenderContext::RenderContext(void* factoryPtr)
 
     LOG_INFO("Initializing for %s", m_Adapter->GetName());
 
-    std::filesystem::path ConfigPath{ "D:\\code\\IronEngine\\" };
-    ConfigPath.append("settings.ini");
-    ConfigFile Config{};
-    if (Result::Fail(Config.Load(ConfigPath.string().c_str()))) {
-        LOG_WARNING("Failed to load settings.ini for renderer!");
-    }
-
-    m_LegacyDevice = atoi(Config.Get("renderer", "force_legacy", "0"));
-
     DeviceInitInfo device_info{};
-    device_info.Backend = m_LegacyDevice ? RHIBackend::DirectX11 : RHIBackend::DirectX12;
-    device_info.Debug = atoi(Config.Get("renderer", "debug_device", "0"));
-    device_info.DisableGPUTimeout = atoi(Config.Get("renderer", "disable_gpu_timeout", "0"));
-    device_info.MaxShaderResources = atoi(Config.Get("renderer", "max_shader_resources", "2048"));
-
-    m_AllowTearing = atoi(Config.Get("renderer", "allow_tearing", "0"));
-    m_TripleBuffering = atoi(Config.Get("renderer", "triple_buffer", "1"));
+    device_info.Backend = g_ForceLegacy ? RHIBackend::DirectX11 : RHIBackend::DirectX12;
+    device_info.Debug = g_DebugDevice;
+    device_info.DisableGPUTimeout = g_DisableGpuTimeout;
+    device_info.MaxShaderResources = (u32)Math::Max(g_MaxShaderResources.Get(), 1);
 
     Result::Code res{ Result::Ok };
     res = m_Factory->CreateDevice(m_Adapter, device_info, &m_Device);
@@ -198,8 +219,8 @@ RenderContext::InitializeForWindow(Window::IWindow* const window) {
     surf_info.Width = window->GetWidth();
     surf_info.Height = window->GetHeight();
     surf_info.Format = RHIFormat::R8G8B8A8_UNORM;
-    surf_info.TripleBuffering = m_TripleBuffering;
-    surf_info.AllowTearing = m_AllowTearing;
+    surf_info.TripleBuffering = g_TripleBuffer;
+    surf_info.AllowTearing = g_AllowTearing;
 
     Result::Code res{ Result::Ok };
     res = m_Device->CreateSurface(surf_info, &m_Surface);
@@ -239,28 +260,31 @@ RenderContext::InitializeForWindow(Window::IWindow* const window) {
     m_Device->CreatePipelineLayout(l_info, &layout);
 
     GraphicsPipelineInitInfo pso_info{ layout };
-    u8* vs_blob{};
-    u64 vs_size{};
-    u8* ps_blob{};
-    u64 ps_size{};
-
-    if (!m_LegacyDevice) {
-        ReadFile("D:\\code\\IronEngine\\EngineAssets\\D3D12\\Bin\\FullscreenVS.bin", vs_blob, vs_size);
-        ReadFile("D:\\code\\IronEngine\\EngineAssets\\D3D12\\Bin\\ColorPS.bin", ps_blob, ps_size);
-    }
-    else {
-        ReadFile("D:\\code\\IronEngine\\EngineAssets\\D3D11\\Bin\\FullscreenVS.bin", vs_blob, vs_size);
-        ReadFile("D:\\code\\IronEngine\\EngineAssets\\D3D11\\Bin\\ColorPS.bin", ps_blob, ps_size);
+    const char* vs_path{ "D:\\code\\IronEngine\\EngineAssets\\D3D12\\Bin\\FullscreenVS.bin" };
+    const char* ps_path{ "D:\\code\\IronEngine\\EngineAssets\\D3D12\\Bin\\ColorPS.bin" };
+
+    if (g_ForceLegacy) {
+        vs_path = "D:\\code\\IronEngine\\EngineAssets\\D3D11\\Bin\\FullscreenVS.bin";
+        ps_path = "D:\\code\\IronEngine\\EngineAssets\\D3D11\\Bin\\ColorPS.bin";
     }
 
-    if (!(vs_blob && ps_blob))
+    // Both shaders are opened and checked on job threads, this thread runs jobs meanwhile
+    MappedFile vs_file{};
+    MappedFile ps_file{};
+    FS::ShaderAsset vs{};
+    FS::ShaderAsset ps{};
+    Task<Result::Code> vs_load{ LoadShader(vs_path, vs_file, vs) };
+    Task<Result::Code> ps_load{ LoadShader(ps_path, ps_file, ps) };
+    SyncWait(WhenAll(vs_load, ps_load));
+
+    if (Result::Fail(vs_load.Result()) || Result::Fail(ps_load.Result())) {
         return Result::EInvalidData;
+    }
 
-    //TODO: WHATTT
-    pso_info.VS.Blob = vs_blob + sizeof(u32);
-    pso_info.VS.Size = vs_size - sizeof(u32);
-    pso_info.PS.Blob = ps_blob + sizeof(u32);
-    pso_info.PS.Size = ps_size - sizeof(u32);
+    pso_info.VS.Blob = vs.Bytecode.Data;
+    pso_info.VS.Size = vs.Bytecode.Count;
+    pso_info.PS.Blob = ps.Bytecode.Data;
+    pso_info.PS.Size = ps.Bytecode.Count;
     pso_info.TargetFormats[0] = RHIFormat::R8G8B8A8_UNORM;
     pso_info.NumTargets = 1;
     pso_info.DepthStencil.DepthEnable = false;
@@ -280,9 +304,6 @@ RenderContext::InitializeForWindow(Window::IWindow* const window) {
 
     m_Device->CreateGraphicsPipeline(pso_info, &pso);
 
-    MemFree(vs_blob);
-    MemFree(ps_blob);
-
     RHIGraphBuilder builder{};
     SetupRenderer(builder);
 
@@ -31,9 +31,5 @@ private:
 
     RHI::IRHISurface*       m_Surface{};
     RHI::IRHIFrameGraph*    m_FrameGraph{};
-
-    bool                    m_AllowTearing : 1{};
-    bool                    m_TripleBuffering : 1{};
-    bool                    m_LegacyDevice : 1{};
 };
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include <Iron.Core/Core.h>
+#include <Iron.Core/Serialize.h>
 
 namespace Iron::FS {
 struct AssetType {
@@ -11,6 +12,20 @@ struct AssetType {
     };
 };
 
+/// Cooked shader bytecode, read in place from the mapped file
+struct ShaderAsset {
+    constexpr static u32 SerialMagic{ MakeFourCC('I', 'S', 'H', 'D') };
+    constexpr static u32 SerialVersion{ 1 };
+
+    SerialView<u8>      Bytecode;
+
+    constexpr static auto SerialFields() {
+        return std::tuple{
+            SerialField("Bytecode", &ShaderAsset::Bytecode),
+        };
+    }
+};
+
 class IAsset {
 public:
     virtual ~IAsset() = 0;
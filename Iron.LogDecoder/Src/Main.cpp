@@ -0,0 +1,365 @@
+#include <Iron.Core/Core.h>
+
+#include <Windows.h>
+#include <stdio.h>
+#include <string.h>
+
+#pragma comment(lib, "iron.core.lib")
+
+using namespace Iron;
+
+namespace {
+constexpr static const char* g_LevelNames[LogLevel::Count]{
+    "[DEBUG]",
+    "[INFO]",
+    "[WARNING]",
+    "[ERROR]",
+    "[FATAL]",
+};
+
+struct SiteInfo {
+    const char* File;       // Both point into the loaded log, not terminated
+    const char* Format;
+    u32         Level;
+    u32         Line;
+    u16         FileLength;
+    u16         FormatLength;
+};
+
+struct ArgReader {
+    const u8*   Data;
+    u32         Size;
+    u32         Offset;
+
+    bool Next(LogArgType::Type& Type, const u8*& Value, u32& Length) {
+        if (Offset >= Size) {
+            return false;
+        }
+
+        Type = (LogArgType::Type)Data[Offset++];
+        switch (Type) {
+        case LogArgType::S32:
+        case LogArgType::U32:
+            Length = 4;
+            break;
+        case LogArgType::S64:
+        case LogArgType::U64:
+        case LogArgType::F64:
+        case LogArgType::Pointer:
+            Length = 8;
+            break;
+        case LogArgType::String: {
+            if (Offset + sizeof(u16) > Size) {
+                return false;
+            }
+
+            u16 StringLength;
+            memcpy(&StringLength, Data + Offset, sizeof(u16));
+            Offset += sizeof(u16);
+            Length = StringLength;
+            break;
+        }
+        default:
+            return false;
+        }
+
+        if (Offset + Length > Size) {
+            return false;
+        }
+
+        Value = Data + Offset;
+        Offset += Length;
+        return true;
+    }
+
+    bool NextInt(s64& Out, bool& Wide) {
+        LogArgType::Type Type;
+        const u8* Value;
+        u32 Length;
+        if (!Next(Type, Value, Length)) {
+            return false;
+        }
+
+        switch (Type) {
+        case LogArgType::S32: {
+            s32 V;
+            memcpy(&V, Value, 4);
+            Out = V;
+            Wide = false;
+            return true;
+        }
+        case LogArgType::U32: {
+            u32 V;
+            memcpy(&V, Value, 4);
+            Out = V;
+            Wide = false;
+            return true;
+        }
+        case LogArgType::S64:
+        case LogArgType::U64:
+        case LogArgType::Pointer:
+            memcpy(&Out, Value, 8);
+            Wide = true;
+            return true;
+        default:
+            return false;
+        }
+    }
+};
+
+// Replays one printf conversion with the recorded argument. Length modifiers of the
+// format are replaced by the width the argument was recorded with.
+void
+RenderConversion(FILE* Out, char* Spec, u32 SpecLength, char Conversion, ArgReader& Args) {
+    char Text[1024];
+
+    if (strchr("diouxXc", Conversion)) {
+        s64 Value;
+        bool Wide;
+        if (!Args.NextInt(Value, Wide)) {
+            fputs("<?>", Out);
+            return;
+        }
+
+        if (Wide && Conversion != 'c') {
+            Spec[SpecLength++] = 'l';
+            Spec[SpecLength++] = 'l';
+            Spec[SpecLength++] = Conversion;
+            Spec[SpecLength] = 0;
+            snprintf(Text, sizeof(Text), Spec, (long long)Value);
+        }
+        else {
+            Spec[SpecLength++] = Conversion;
+            Spec[SpecLength] = 0;
+            snprintf(Text, sizeof(Text), Spec, (int)Value);
+        }
+
+        fputs(Text, Out);
+        return;
+    }
+
+    LogArgType::Type Type;
+    const u8* Value;
+    u32 Length;
+    if (!Args.Next(Type, Value, Length)) {
+        fputs("<?>", Out);
+        return;
+    }
+
+    Spec[SpecLength++] = Conversion;
+    Spec[SpecLength] = 0;
+
+    if (strchr("fFeEgGaA", Conversion) && Type == LogArgType::F64) {
+        double V;
+        memcpy(&V, Value, 8);
+        snprintf(Text, sizeof(Text), Spec, V);
+    }
+    // Wide strings were narrowed when recorded, MSVC's %S prints them like %s
+    else if ((Conversion == 's' || Conversion == 'S') && Type == LogArgType::String) {
+        Spec[SpecLength - 1] = 's';
+        char String[512];
+        const u32 Count{ Math::Min(Length, (u32)sizeof(String) - 1) };
+        memcpy(String, Value, Count);
+        String[Count] = 0;
+        snprintf(Text, sizeof(Text), Spec, String);
+    }
+    else if (Conversion == 'p' && Length == 8 && Type != LogArgType::F64) {
+        u64 V;
+        memcpy(&V, Value, 8);
+        snprintf(Text, sizeof(Text), Spec, (void*)(size_t)V);
+    }
+    else {
+        snprintf(Text, sizeof(Text), "<?>");
+    }
+
+    fputs(Text, Out);
+}
+
+void
+RenderMessage(FILE* Out, const SiteInfo& Site, ArgReader& Args) {
+    const char* F{ Site.Format };
+    const char* const End{ Site.Format + Site.FormatLength };
+
+    while (F < End) {
+        if (*F != '%') {
+            fputc(*F++, Out);
+            continue;
+        }
+
+        if (++F < End && *F == '%') {
+            fputc('%', Out);
+            ++F;
+            continue;
+        }
+
+        char Spec[48]{ '%' };
+        u32 SpecLength{ 1 };
+        constexpr u32 SpecMax{ sizeof(Spec) - 4 };
+
+        while (F < End && strchr("-+ #0", *F) && SpecLength < SpecMax) {
+            Spec[SpecLength++] = *F++;
+        }
+
+        // Widths and precisions given as '*' consume an int argument
+        for (u32 Part{ 0 }; Part < 2; ++Part) {
+            if (Part == 1) {
+                if (F >= End || *F != '.') {
+                    break;
+                }
+                Spec[SpecLength++] = *F++;
+            }
+
+            if (F < End && *F == '*') {
+                s64 Value;
+                bool Wide;
+                if (!Args.NextInt(Value, Wide)) {
+                    Value = 0;
+                }
+                // snprintf returns the untruncated length
+                SpecLength = Math::Min(SpecMax - 1,
+                    SpecLength + (u32)snprintf(Spec + SpecLength, SpecMax - SpecLength, "%d", (int)Value));
+                ++F;
+            }
+
+            while (F < End && *F >= '0' && *F <= '9' && SpecLength < SpecMax) {
+                Spec[SpecLength++] = *F++;
+            }
+        }
+
+        while (F < End && strchr("hlLjztqwI", *F)) {
+            if (*F == 'I' && End - F >= 3 && (!strncmp(F + 1, "64", 2) || !strncmp(F + 1, "32", 2))) {
+                F += 2;
+            }
+            ++F;
+        }
+
+        if (F >= End) {
+            break;
+        }
+
+        const char Conversion{ *F++ };
+        if (Conversion == 'n') {
+            continue;
+        }
+
+        RenderConversion(Out, Spec, SpecLength, Conversion, Args);
+    }
+}
+
+Result::Code
+Decode(const u8* Data, u64 Length, FILE* Out) {
+    if (Length < sizeof(BinaryLog::Header)) {
+        return Result::EInvalidData;
+    }
+
+    BinaryLog::Header Header;
+    memcpy(&Header, Data, sizeof(Header));
+    if (Header.Magic != BinaryLog::Magic || Header.Version != BinaryLog::Version || !Header.TickFrequency) {
+        return Result::EInvalidData;
+    }
+
+    FILETIME Time{ (DWORD)Header.StartTime, (DWORD)(Header.StartTime >> 32) };
+    SYSTEMTIME Start{};
+    FileTimeToSystemTime(&Time, &Start);
+    fprintf(Out, "Log started %04u-%02u-%02u %02u:%02u:%02u UTC\n",
+        Start.wYear, Start.wMonth, Start.wDay, Start.wHour, Start.wMinute, Start.wSecond);
+
+    // Ids count up from 1, so every id has a site record of its own in the file
+    const u64 MaxSiteId{ Length / sizeof(BinaryLog::Site) };
+    Vector<SiteInfo> Sites{};
+    u64 Torn{ 0 };
+    u64 Unknown{ 0 };
+
+    for (u64 Offset{ sizeof(BinaryLog::Header) }; Offset + sizeof(BinaryLog::Record) <= Length;) {
+        BinaryLog::Record Record;
+        memcpy(&Record, Data + Offset, sizeof(Record));
+        if (!Record.Size || Offset + Record.Size > Length) {
+            break;
+        }
+
+        const u8* const Body{ Data + Offset };
+        Offset += Record.Size;
+
+        if (Record.Type == BinaryLog::RecordType::Site && Record.Size >= sizeof(BinaryLog::Site)) {
+            BinaryLog::Site S;
+            memcpy(&S, Body, sizeof(S));
+            if (sizeof(S) + S.FileLength + S.FormatLength > Record.Size || S.Level >= LogLevel::Count
+                || !S.Id || S.Id > MaxSiteId) {
+                continue;
+            }
+
+            if (S.Id >= Sites.Size()) {
+                Sites.Resize(S.Id + 1);
+            }
+
+            const char* const Strings{ (const char*)Body + sizeof(S) };
+            Sites[S.Id] = { Strings, Strings + S.FileLength, S.Level, S.Line, S.FileLength, S.FormatLength };
+        }
+        else if (Record.Type == BinaryLog::RecordType::Event && Record.Size >= sizeof(BinaryLog::Event)) {
+            BinaryLog::Event E;
+            memcpy(&E, Body, sizeof(E));
+            if (E.Site >= Sites.Size() || !Sites[E.Site].Format) {
+                ++Unknown;
+                continue;
+            }
+
+            const SiteInfo& Site{ Sites[E.Site] };
+            const double Seconds{ (double)(s64)(E.Ticks - Header.StartTicks) / (double)Header.TickFrequency };
+            fprintf(Out, "[%12.6f] [%6u] %s %.*s:%u ", Seconds, E.ThreadId,
+                g_LevelNames[Site.Level], (int)Site.FileLength, Site.File, Site.Line);
+
+            ArgReader Args{ Body + sizeof(E), Record.Size - (u32)sizeof(E), 0 };
+            RenderMessage(Out, Site, Args);
+            fputc('\n', Out);
+        }
+        else if (Record.Type == BinaryLog::RecordType::None) {
+            ++Torn;
+        }
+    }
+
+    if (Torn || Unknown) {
+        fprintf(Out, "%llu incomplete and %llu unresolved records skipped\n", Torn, Unknown);
+    }
+
+    if (Header.Dropped) {
+        fprintf(Out, "%llu records did not fit and were dropped\n", Header.Dropped);
+    }
+
+    return Result::Ok;
+}
+} // anonymous namespace
+
+int
+main(int ArgC, char** ArgV) {
+    if (ArgC < 2) {
+        printf("Usage: Iron.LogDecoder <log file> [output file]\n");
+        return 1;
+    }
+
+    u8* Data{};
+    u64 Length{};
+    Result::Code Res{ ReadFile(ArgV[1], Data, Length) };
+    if (Result::Fail(Res)) {
+        printf("Failed to read %s\n", ArgV[1]);
+        return 1;
+    }
+
+    FILE* Out{ stdout };
+    if (ArgC > 2 && fopen_s(&Out, ArgV[2], "w")) {
+        printf("Failed to open %s\n", ArgV[2]);
+        MemFree(Data);
+        return 1;
+    }
+
+    Res = Decode(Data, Length, Out);
+    if (Result::Fail(Res)) {
+        printf("%s is not a binary log\n", ArgV[1]);
+    }
+
+    if (Out != stdout) {
+        fclose(Out);
+    }
+
+    MemFree(Data);
+    return Result::Fail(Res) ? 1 : 0;
+}
@@ -146,10 +146,10 @@ public:
 
     struct FGPassDesc
     {
-        const char*                     Name{};
-        FGPassFunc                      Func{};
-        Vector<FGResourceUsage>         Reads{};
-        Vector<FGResourceUsage>         Writes{};
+        const char*                         Name{};
+        FGPassFunc                          Func{};
+        InlineVector<FGResourceUsage, 8>    Reads{};
+        InlineVector<FGResourceUsage, 8>    Writes{};
     };
 
 public:
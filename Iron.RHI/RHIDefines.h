@@ -483,7 +483,7 @@ struct SurfaceInitInfo {
 };
 
 struct RHIBlob {
-    u8*                             Blob;
+    const u8*                       Blob;
     u64                             Size;
 };
 
@@ -905,8 +905,27 @@ public:
         :
         m_Stream(),
         m_Offset(),
-        m_Capacity(capacity) {
-        m_Stream = (u8*)MemAlloc(capacity);
+        m_Capacity(capacity),
+        m_OwnsStream(true) {
+        m_Stream = (u8*)MemAlloc(capacity, MemTag::RHI);
+        if (!m_Stream) {
+            LOG_ERROR("No command stream memory!");
+        }
+    }
+
+    // Records into caller owned memory, e.g. from the frame arena
+    // Falls back to a heap stream if no memory was provided
+    RHICommandBuilder(u8* stream, u32 capacity)
+        :
+        m_Stream(stream),
+        m_Offset(),
+        m_Capacity(capacity),
+        m_OwnsStream(false) {
+        if (!m_Stream) {
+            m_Stream = (u8*)MemAlloc(capacity, MemTag::RHI);
+            m_OwnsStream = true;
+        }
+
         if (!m_Stream) {
             LOG_ERROR("No command stream memory!");
         }
@@ -916,7 +935,9 @@ public:
     RHICommandBuilder& operator=(const RHICommandBuilder&) = delete;
 
     ~RHICommandBuilder() {
-        MemFree(m_Stream);
+        if (m_OwnsStream) {
+            MemFree(m_Stream, MemTag::RHI);
+        }
     }
 
     template<typename T>
@@ -960,10 +981,13 @@ private:
     u8*         m_Stream;
     u32         m_Offset;
     u32         m_Capacity;
+    bool        m_OwnsStream;
 };
 
 class RHICopyCommandList : public RHICommandBuilder {
 public:
+    using RHICommandBuilder::RHICommandBuilder;
+
     inline void CopyResource(RHIResource Src,
         RHIResource Dst) {
         auto* cmd{ Allocate<CmdCopyResourceInfo>(CommandId::CopyResource) };
@@ -975,6 +999,8 @@ public:
 
 class RHIComputeCommandList : public RHICopyCommandList {
 public:
+    using RHICopyCommandList::RHICopyCommandList;
+
     inline void SetComputeLayout(RHIPipelineLayout layout) {
         auto* cmd{ Allocate<CmdSetComputeLayoutInfo>(CommandId::SetComputeLayout) };
         RHI_VALIDATE_CMD(cmd);
@@ -999,6 +1025,8 @@ public:
 
 class RHIGraphicsCommandList : public RHIComputeCommandList {
 public:
+    using RHIComputeCommandList::RHIComputeCommandList;
+
     inline void SetGraphicsLayout(RHIPipelineLayout layout) {
         auto* cmd{ Allocate<CmdSetGraphicsLayoutInfo>(CommandId::SetGraphicsLayout) };
         RHI_VALIDATE_CMD(cmd);
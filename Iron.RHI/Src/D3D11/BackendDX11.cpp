@@ -1,7 +1,6 @@
 #include <Iron.RHI/Src/D3D11/BackendDX11.h>
 
 #include <wrl.h>
-#include <unordered_map>
 #include <algorithm>
 #include <queue>
 
@@ -920,25 +919,13 @@ CRHIDevice_DX11::CreateResource(const ResourceInitInfo& info,
         return Result::ECreateResource;
     }
 
-    u32 sparse_index{};
-    if (!m_FreeSparseResources.Empty()) {
-        sparse_index = m_FreeSparseResources.Back();
-        m_FreeSparseResources.PopBack();
-    }
-    else {
-        sparse_index = m_SparseResources.Size();
-        m_SparseResources.PushBack({});
+    const RHIResource handle{ m_Resources.Insert(dense) };
+    if (!Id::IsValid(handle)) {
+        SafeRelease(dense.Resource);
+        return Result::ENomemory;
     }
 
-    dense.SparseIndex = sparse_index;
-
-    const u32 dense_index{ m_DenseResources.Size() };
-    m_DenseResources.EmplaceBack(dense);
-
-    auto& slot{ m_SparseResources[sparse_index] };
-    slot.DenseIndex = dense_index;
-
-    *resource = Id::MakeHandle(sparse_index, slot.Generation);
+    *resource = handle;
 
     return Result::Ok;
 }
@@ -1347,32 +1334,14 @@ CRHIDevice_DX11::CreateFrameGraph(const RHIGraphBuilder& builder,
 
 void
 CRHIDevice_DX11::DestroyResource(RHIResource resource) {
-    if (!Id::IsValid(resource)) {
-        return;
-    }
-
-    u32 sparse_index{ Id::Index(resource) };
-    auto& slot{ m_SparseResources[sparse_index] };
-
-    if (slot.Generation != Id::Generation(resource)) {
+    DenseResource* removed{ m_Resources.Get(resource) };
+    if (!removed) {
         return;
     }
 
-    const u32 dense_index{ slot.DenseIndex };
-    const u32 last_dense{ m_DenseResources.Size() - 1 };
-    const u32 moved_sparse{ m_DenseResources[last_dense].SparseIndex };
-    DenseResource& removed{ m_DenseResources[dense_index] };
+    SafeRelease(removed->Resource);
 
-    SafeRelease(removed.Resource);
-
-    std::swap(m_DenseResources[dense_index], m_DenseResources[last_dense]);
-
-    m_SparseResources[moved_sparse].DenseIndex = dense_index;
-
-    m_DenseResources.PopBack();
-
-    ++slot.Generation;
-    m_FreeSparseResources.PushBack(sparse_index);
+    m_Resources.Erase(resource);
 }
 
 void
@@ -1486,17 +1455,8 @@ CRHIDevice_DX11::GetNative() const {
 
 const CRHIDevice_DX11::DenseResource
 CRHIDevice_DX11::ResolveResource(RHIResource handle) const {
-    if (!Id::IsValid(handle))
-        return {};
-
-    u32 index{ Id::Index(handle) };
-    u32 gen{ Id::Generation(handle) };
-
-    const auto& slot{ m_SparseResources[index] };
-    if (slot.Generation != gen)
-        return {};
-
-    return m_DenseResources[slot.DenseIndex];
+    const DenseResource* res{ m_Resources.Get(handle) };
+    return res ? *res : DenseResource{};
 }
 
 const
@@ -1748,7 +1708,7 @@ CRHIFrameGraph_DX11::Initialize(
         }
     }
     using namespace Shared;
-    std::unordered_map<ViewCacheEntry, u32, ViewCacheHasher> view_cache;
+    HashMap<ViewCacheEntry, u32, ViewCacheHasher> view_cache;
 
     for (u32 i{ 0 }; i < (u32)m_Passes.Size(); ++i) {
         const RHIGraphBuilder::FGPassDesc& pass_desc{ passes[i] };
@@ -1772,8 +1732,8 @@ CRHIFrameGraph_DX11::Initialize(
             entry.LayerCount = read.Range.LayerCount;
             entry.Plane = read.Range.Plane;
 
-            auto it = view_cache.find(entry);
-            if (it == view_cache.end()) {
+            const u32* const cached{ view_cache.Find(entry) };
+            if (!cached) {
                 if (read.State & ResourceState::PixelResource
                     || read.State & ResourceState::NonPixelResource) {
                     View view{};
@@ -1804,7 +1764,7 @@ CRHIFrameGraph_DX11::Initialize(
                     }
 
                     const u32 view_id{ m_DescViews.Size() };
-                    view_cache[entry] = view_id;
+                    view_cache.Emplace(entry, view_id);
                     m_DescViews.EmplaceBack(view);
 
                     BoundView binding{};
@@ -1839,7 +1799,7 @@ CRHIFrameGraph_DX11::Initialize(
                     }
 
                     const u32 view_id{ m_DescViews.Size() };
-                    view_cache[entry] = view_id;
+                    view_cache.Emplace(entry, view_id);
                     m_DescViews.EmplaceBack(view);
 
                     compiled.HasDsv = 1;
@@ -1851,13 +1811,13 @@ CRHIFrameGraph_DX11::Initialize(
                 if (read.State & ResourceState::PixelResource
                     || read.State & ResourceState::NonPixelResource) {
                     BoundView binding{};
-                    binding.View = (u16)it->second;
+                    binding.View = (u16)*cached;
                     binding.Slot = (u16)slot;
                     compiled.Srvs.PushBack(binding);
                 }
                 else if (read.State & ResourceState::DepthRead) {
                     compiled.HasDsv = 1;
-                    compiled.Dsv.View = (u16)it->second;
+                    compiled.Dsv.View = (u16)*cached;
                     compiled.Dsv.Slot = (u16)slot;
                 }
             }
@@ -1897,8 +1857,8 @@ CRHIFrameGraph_DX11::Initialize(
             entry.BaseLayer = write.Range.BaseLayer;
             entry.LayerCount = write.Range.LayerCount;
             entry.Plane = write.Range.Plane;
-            auto it = view_cache.find(entry);
-            if (it == view_cache.end()) {
+            const u32* const cached{ view_cache.Find(entry) };
+            if (!cached) {
                 if (write.State & ResourceState::RenderTarget) {
                     View view{};
                     view.Resource = (u16)entry.Resource;
@@ -1928,7 +1888,7 @@ CRHIFrameGraph_DX11::Initialize(
 
                     const u32 view_id{ m_DescViews.Size() };
 
-                    view_cache[entry] = view_id;
+                    view_cache.Emplace(entry, view_id);
                     m_DescViews.EmplaceBack(view);
 
                     compiled.NumRtvs++;
@@ -1962,7 +1922,7 @@ CRHIFrameGraph_DX11::Initialize(
                     }
 
                     const u32 view_id{ m_DescViews.Size() };
-                    view_cache[entry] = view_id;
+                    view_cache.Emplace(entry, view_id);
                     m_DescViews.EmplaceBack(view);
 
                     compiled.HasDsv = 1;
@@ -1974,11 +1934,11 @@ CRHIFrameGraph_DX11::Initialize(
                 if (write.State & ResourceState::RenderTarget) {
                     compiled.NumRtvs++;
                     compiled.Rtvs[slot].Slot = (u16)slot;
-                    compiled.Rtvs[slot].View = (u16)it->second;
+                    compiled.Rtvs[slot].View = (u16)*cached;
                 }
                 else if (write.State & ResourceState::DepthRead) {
                     compiled.HasDsv = 1;
-                    compiled.Dsv.View = (u16)it->second;
+                    compiled.Dsv.View = (u16)*cached;
                     compiled.Dsv.Slot = (u16)write.Slot;
                 }
             }
@@ -2009,7 +1969,9 @@ CRHIFrameGraph_DX11::Execute(
         cmd_data.InitPCBuffer(1024);
     }
 
-    RHIGraphicsCommandList builder{ 1024 * 1024 };
+    // Stream memory comes from the frame arena and is reclaimed when the frame retires
+    constexpr u32 stream_size{ 1024 * 1024 };
+    RHIGraphicsCommandList builder{ (u8*)FrameAlloc(stream_size, RHI_COMMAND_ALIGN), stream_size };
     builder.Reset();
 
     for (auto& pass : m_Passes) {
@@ -2076,8 +2038,8 @@ CRHIFrameGraph_DX11::GetDependencies(
 
     Vector<Vector<u32>> dependencies(num_passes);
 
-    std::unordered_map<FGResource, Vector<u32>> writers;
-    writers.reserve(num_passes * 2);
+    HashMap<FGResource, Vector<u32>> writers;
+    writers.Reserve(num_passes * 2);
 
     for (u32 passIndex{ 0 }; passIndex < num_passes; ++passIndex) {
         for (const RHIGraphBuilder::FGResourceUsage& write : passes[passIndex].Writes) {
@@ -2089,11 +2051,11 @@ CRHIFrameGraph_DX11::GetDependencies(
         auto& deps = dependencies[passIndex];
 
         for (const RHIGraphBuilder::FGResourceUsage& read : passes[passIndex].Reads) {
-            auto it = writers.find(read.Resource);
-            if (it == writers.end())
+            const Vector<u32>* const resource_writers{ writers.Find(read.Resource) };
+            if (!resource_writers)
                 continue;
 
-            for (u32 writerPass : it->second) {
+            for (u32 writerPass : *resource_writers) {
                 if (writerPass != passIndex) {
                     deps.PushBack(writerPass);
                 }
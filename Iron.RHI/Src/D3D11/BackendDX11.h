@@ -3,7 +3,6 @@
 
 #include <d3d11_4.h>
 #include <dxgi1_6.h>
-#include <unordered_map>
 
 namespace Iron::RHI::D3D11 {
 template<typename T>
@@ -61,11 +60,6 @@ struct D3D11FeatureTraits<D3D11_FEATURE_DATA_THREADING> {
 
 class CRHIDevice_DX11 : public IRHIDevice {
 public:
-    struct ResourceSlot {
-        u32         Generation : Id::GenerationBits{};
-        u32         DenseIndex : (32 - Id::GenerationBits) {};
-    };
-
     struct DenseResource {
         enum ResourceType : u32 {
             EBuffer = 0,
@@ -74,8 +68,7 @@ public:
             ETexture3D,
         };
 
-        u32             Type : 2;
-        u32             SparseIndex : 30;
+        u32             Type;
         ID3D11Resource* Resource;
     };
 
@@ -100,9 +93,9 @@ public:
     struct RefCountedStorage {
     public:
         PsoHandle<T> Retrieve(u64 hash) {
-            auto it{ m_HashMap.find(hash) };
-            if (it != m_HashMap.end()) {
-                const u32 index{ it->second };
+            const u32* const cached{ m_HashMap.Find(hash) };
+            if (cached) {
+                const u32 index{ *cached };
                 m_Data[index].RefCount++;
                 return { m_Data[index].Ptr, index };
             }
@@ -112,7 +105,7 @@ public:
 
         PsoHandle<T> AddNewItem(u64 hash, T* ptr) {
             const u32 index{ m_Data.Size() };
-            m_HashMap[hash] = index;
+            m_HashMap.Emplace(hash, index);
             m_Data.EmplaceBack(ptr, hash, 1);
             return {  ptr, index };
         }
@@ -132,7 +125,7 @@ public:
             }
 
             SafeRelease(it.Ptr);
-            m_HashMap.erase(it.Hash);
+            m_HashMap.Erase(it.Hash);
             it.Ptr = nullptr;
             handle.Ptr = nullptr;
         }
@@ -143,7 +136,7 @@ public:
             }
 
             m_Data.Clear();
-            m_HashMap.clear();
+            m_HashMap.Clear();
         }
 
     private:
@@ -154,7 +147,7 @@ public:
         };
 
         Vector<Item>                    m_Data;
-        std::unordered_map<u64, u32>    m_HashMap;
+        HashMap<u64, u32>               m_HashMap;
 
     };
 
@@ -307,9 +300,7 @@ private:
 
     DeviceFeatures              m_Features;
 
-    Vector<ResourceSlot>        m_SparseResources;
-    Vector<DenseResource>       m_DenseResources;
-    Vector<u32>                 m_FreeSparseResources;
+    SlotMap<DenseResource>      m_Resources;
 
     Vector<PipelineLayoutParam> m_PipelineParams;
     Vector<PipelineLayout>      m_PipelineLayouts;
@@ -3,9 +3,7 @@
 #include <wrl.h>
 #include <format>
 #include <cassert>
-#include <unordered_map>
 #include <algorithm>
-#include <queue>
 
 using Microsoft::WRL::ComPtr;
 
@@ -723,28 +721,27 @@ DX12DescriptorHeap::Allocate(u32 count) {
 
 void
 DX12DescriptorHeap::Free(u32 index, u64 fence_value) {
-    m_PendingFrees.push_back({ fence_value, index });
+    m_PendingFrees.Push({ fence_value, index });
 }
 
 void
 DX12DescriptorHeap::Free(u32 base, u32 count, u64 fence_value) {
     for (u32 i = 0; i < count; ++i)
-        m_PendingFrees.push_back({ fence_value, base + i });
+        m_PendingFrees.Push({ fence_value, base + i });
 }
 
 void
 DX12DescriptorHeap::Collect(u64 fence) {
-    while (!m_PendingFrees.empty()) {
-        auto& pf = m_PendingFrees.front();
-        if (pf.FenceValue == fence) {
-            m_FreeList.PushBack(pf.Index);
-            m_PendingFrees.pop_front();
+    while (const PendingFree* pf = m_PendingFrees.Peek()) {
+        if (pf->FenceValue == fence) {
+            m_FreeList.PushBack(pf->Index);
+            m_PendingFrees.Pop();
         }
         else
             break;
     }
 
-    std::sort(m_FreeList.begin(), m_FreeList.end());
+    ParallelSort(m_FreeList);
 }
 
 HeapAllocInfo
@@ -1337,25 +1334,13 @@ CRHIDevice_DX12::CreateResource(const ResourceInitInfo& info,
         dense.RowPitch = info.Width;
     }
 
-    u32 sparse_index{};
-    if (!m_FreeSparseResources.Empty()) {
-        sparse_index = m_FreeSparseResources.Back();
-        m_FreeSparseResources.PopBack();
-    }
-    else {
-        sparse_index = m_SparseResources.Size();
-        m_SparseResources.PushBack({});
+    const RHIResource handle{ m_Resources.Insert(dense) };
+    if (!Id::IsValid(handle)) {
+        SafeRelease(dense.Resource);
+        return Result::ENomemory;
     }
 
-    dense.SparseIndex = sparse_index;
-
-    const u32 dense_index{ m_DenseResources.Size() };
-    m_DenseResources.EmplaceBack(dense);
-
-    auto& slot{ m_SparseResources[sparse_index] };
-    slot.DenseIndex = dense_index;
-
-    *resource = Id::MakeHandle(sparse_index, slot.Generation);
+    *resource = handle;
 
     return Result::Ok;
 }
@@ -1530,8 +1515,8 @@ CRHIDevice_DX12::CreateComputePipeline(const ComputePipelineInitInfo& info,
     desc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
 
     const u64 hash{ HashComputePSODesc(desc) };
-    const auto it{ m_PsoMap.find(hash) };
-    if (it == m_PsoMap.end()) {
+    const u32* const cached{ m_PsoMap.Find(hash) };
+    if (!cached) {
         ID3D12PipelineState* pso{ nullptr };
 
         HRESULT hr{ S_OK };
@@ -1557,10 +1542,10 @@ CRHIDevice_DX12::CreateComputePipeline(const ComputePipelineInitInfo& info,
 
         *outHandle = Id::MakeHandle(index, m_Pipelines[index].Generation);
 
-        m_PsoMap[hash] = index;
+        m_PsoMap.Emplace(hash, index);
     }
     else {
-        const u32 index{ it->second };
+        const u32 index{ *cached };
         m_Pipelines[index].RefCount++;
         *outHandle = Id::MakeHandle(index, m_Pipelines[index].Generation);
     }
@@ -1683,8 +1668,8 @@ CRHIDevice_DX12::CreateGraphicsPipeline(
     desc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
 
     const u64 hash{ HashGraphicsPSODesc(desc) };
-    const auto it{ m_PsoMap.find(hash) };
-    if (it == m_PsoMap.end()) {
+    const u32* const cached{ m_PsoMap.Find(hash) };
+    if (!cached) {
         ID3D12PipelineState* pso{ nullptr };
         HRESULT hr{ S_OK };
         hr = m_Device->CreateGraphicsPipelineState(&desc,
@@ -1708,10 +1693,10 @@ CRHIDevice_DX12::CreateGraphicsPipeline(
         m_Pipelines[index].Hash = hash;
 
         *outHandle = Id::MakeHandle(index, m_Pipelines[index].Generation);
-        m_PsoMap[hash] = index;
+        m_PsoMap.Emplace(hash, index);
     }
     else {
-        const u32 index{ it->second };
+        const u32 index{ *cached };
         m_Pipelines[index].RefCount++;
         *outHandle = Id::MakeHandle(index, m_Pipelines[index].Generation);
     }
@@ -1762,33 +1747,15 @@ CRHIDevice_DX12::CreateFrameGraph(const RHIGraphBuilder& builder,
 void
 CRHIDevice_DX12::DestroyResource(
     RHIResource resource) {
-    if (!Id::IsValid(resource)) {
-        return;
-    }
-
-    u32 sparse_index{ Id::Index(resource) };
-    auto& slot{ m_SparseResources[sparse_index] };
-
-    if (slot.Generation != Id::Generation(resource)) {
+    DenseResource* removed{ m_Resources.Get(resource) };
+    if (!removed) {
         return;
     }
 
-    const u32 dense_index{ slot.DenseIndex };
-    const u32 last_dense{ m_DenseResources.Size() - 1 };
-    const u32 moved_sparse{ m_DenseResources[last_dense].SparseIndex };
-    DenseResource& removed{ m_DenseResources[dense_index] };
-
-    SafeRelease(removed.Resource);
+    SafeRelease(removed->Resource);
     //m_BufferHeaps.Free(removed.Info);
 
-    std::swap(m_DenseResources[dense_index], m_DenseResources[last_dense]);
-
-    m_SparseResources[moved_sparse].DenseIndex = dense_index;
-
-    m_DenseResources.PopBack();
-
-    ++slot.Generation;
-    m_FreeSparseResources.PushBack(sparse_index);
+    m_Resources.Erase(resource);
 }
 
 void
@@ -1832,7 +1799,7 @@ CRHIDevice_DX12::DestroyPipeline(
     else {
         auto& pipe = m_Pipelines[index];
 
-        m_PsoMap.erase(pipe.Hash);
+        m_PsoMap.Erase(pipe.Hash);
 
         SafeRelease(pipe.Pso);
 
@@ -1930,17 +1897,8 @@ CRHIDevice_DX12::GetNative() const {
 
 CRHIDevice_DX12::DenseResource
 CRHIDevice_DX12::ResolveResource(RHIResource handle) const {
-    if (!Id::IsValid(handle))
-        return {};
-
-    u32 index{ Id::Index(handle) };
-    u32 gen{ Id::Generation(handle) };
-
-    const auto& slot{ m_SparseResources[index] };
-    if (slot.Generation != gen)
-        return {};
-
-    return m_DenseResources[slot.DenseIndex];
+    const DenseResource* res{ m_Resources.Get(handle) };
+    return res ? *res : DenseResource{};
 }
 
 CRHIDevice_DX12::PipelineLayout
@@ -2147,13 +2105,15 @@ CRHIFrameGraph_DX12::Initialize(
 
     m_Parent = device;
 
-    const Vector<Vector<u32>> dependencies{ GetDependencies(builder) };
+    ScratchScope scratch{};
+
+    const DependencyList dependencies{ GetDependencies(builder) };
     if ((u32)(flags & FGCompileFlags::LogInfo)) {
         PrintDependencies(dependencies);
     }
 
     ID3D12Device14* const d3d12{ (ID3D12Device14* const)device->GetNative() };
-    const Vector<u32> sorted{ TopologicalSort(dependencies) };
+    const ScratchVector<u32> sorted{ TopologicalSort(dependencies) };
     const Vector<RHIGraphBuilder::FGPassDesc>& passes{ builder.GetPasses() };
     const Vector<FGResourceInitInfo>& resources{ builder.GetResources() };
     const bool debug_names{ (const bool)(flags & FGCompileFlags::DebugNames) };
@@ -2166,7 +2126,7 @@ CRHIFrameGraph_DX12::Initialize(
     using namespace Shared;
 
     m_DescResources.Resize(resources.Size());
-    Vector<D3D12_RESOURCE_DESC> resource_descs{};
+    ScratchVector<D3D12_RESOURCE_DESC> resource_descs{};
 
     u32 total_count{};
 
@@ -2233,7 +2193,7 @@ CRHIFrameGraph_DX12::Initialize(
             resource_descs.Data())
     };
 
-    Vector<D3D12_RESOURCE_STATES> last_states{};
+    ScratchVector<D3D12_RESOURCE_STATES> last_states{};
     last_states.Resize(m_DescResources.Size());
 
     if (!alloc_info.SizeInBytes) {
@@ -2320,7 +2280,7 @@ CRHIFrameGraph_DX12::Initialize(
         }
     }
 
-    std::unordered_map<ViewCacheEntry, u32, ViewCacheHasher> view_cache;
+    HashMap<ViewCacheEntry, u32, ViewCacheHasher> view_cache;
 
     u16 srv_heap_index{ 0 };
     u16 rtv_heap_index{ 0 };
@@ -2357,8 +2317,8 @@ CRHIFrameGraph_DX12::Initialize(
             barrier.After = new_state;
             last_states[read.Resource] = new_state;
 
-            auto it = view_cache.find(entry);
-            if (it == view_cache.end()) {
+            const u32* const cached{ view_cache.Find(entry) };
+            if (!cached) {
                 if (read.State & ResourceState::PixelResource
                     || read.State & ResourceState::NonPixelResource) {
                     View view{};
@@ -2386,7 +2346,7 @@ CRHIFrameGraph_DX12::Initialize(
                     srv_heap_index += resource.Count;
 
                     const u32 view_id{ m_DescViews.Size() };
-                    view_cache[entry] = view_id;
+                    view_cache.Emplace(entry, view_id);
                     m_DescViews.EmplaceBack(view);
 
                     BoundView binding{};
@@ -2418,7 +2378,7 @@ CRHIFrameGraph_DX12::Initialize(
                     dsv_heap_index += resource.Count;
 
                     const u32 view_id{ m_DescViews.Size() };
-                    view_cache[entry] = view_id;
+                    view_cache.Emplace(entry, view_id);
                     m_DescViews.EmplaceBack(view);
 
                     compiled.HasDsv = 1;
@@ -2430,13 +2390,13 @@ CRHIFrameGraph_DX12::Initialize(
                 if (read.State & ResourceState::PixelResource
                     || read.State & ResourceState::NonPixelResource) {
                     BoundView binding{};
-                    binding.View = (u16)it->second;
+                    binding.View = (u16)*cached;
                     binding.Slot = (u16)slot;
                     compiled.Srvs.PushBack(binding);
                 }
                 else if (read.State & ResourceState::DepthRead) {
                     compiled.HasDsv = 1;
-                    compiled.Dsv.View = (u16)it->second;
+                    compiled.Dsv.View = (u16)*cached;
                     compiled.Dsv.Slot = (u16)slot;
                 }
             }
@@ -2496,8 +2456,8 @@ CRHIFrameGraph_DX12::Initialize(
 
             compiled.Barriers.PushBack(barrier);
 
-            auto it = view_cache.find(entry);
-            if (it == view_cache.end()) {
+            const u32* const cached{ view_cache.Find(entry) };
+            if (!cached) {
                 if (write.State & ResourceState::RenderTarget) {
                     View view{};
                     view.Resource = (u16)entry.Resource;
@@ -2522,7 +2482,7 @@ CRHIFrameGraph_DX12::Initialize(
 
                     const u32 view_id{ m_DescViews.Size() };
 
-                    view_cache[entry] = view_id;
+                    view_cache.Emplace(entry, view_id);
                     m_DescViews.EmplaceBack(view);
 
                     compiled.NumRtvs++;
@@ -2552,7 +2512,7 @@ CRHIFrameGraph_DX12::Initialize(
                     dsv_heap_index += resource.Count;
 
                     const u32 view_id{ m_DescViews.Size() };
-                    view_cache[entry] = view_id;
+                    view_cache.Emplace(entry, view_id);
                     m_DescViews.EmplaceBack(view);
 
                     compiled.HasDsv = 1;
@@ -2564,11 +2524,11 @@ CRHIFrameGraph_DX12::Initialize(
                 if (write.State & ResourceState::RenderTarget) {
                     compiled.NumRtvs++;
                     compiled.Rtvs[slot].Slot = (u16)slot;
-                    compiled.Rtvs[slot].View = (u16)it->second;
+                    compiled.Rtvs[slot].View = (u16)*cached;
                 }
                 else if (write.State & ResourceState::DepthRead) {
                     compiled.HasDsv = 1;
-                    compiled.Dsv.View = (u16)it->second;
+                    compiled.Dsv.View = (u16)*cached;
                     compiled.Dsv.Slot = (u16)write.Slot;
                 }
             }
@@ -2601,8 +2561,9 @@ CRHIFrameGraph_DX12::Execute(
     Cmd::CommandListData cmd_data{};
     cmd_data.List = ctx.List;
     cmd_data.Device = m_Parent;
-    //TODO: Dont realloc every frame!
-    RHIGraphicsCommandList builder{ 1024 * 1024 };
+    // Stream memory comes from the frame arena and is reclaimed when the frame retires
+    constexpr u32 stream_size{ 1024 * 1024 };
+    RHIGraphicsCommandList builder{ (u8*)FrameAlloc(stream_size, RHI_COMMAND_ALIGN), stream_size };
     builder.Reset();
 
     ID3D12Resource* const surface_buffer{ (ID3D12Resource* const)dx_surface->GetNativeBuffer(dx_surface->GetCurrentBBIndex()) };
@@ -2708,19 +2669,25 @@ CRHIFrameGraph_DX12::Execute(
         false);
 }
 
-Vector<Vector<u32>>
+CRHIFrameGraph_DX12::DependencyList
 CRHIFrameGraph_DX12::GetDependencies(
     const RHIGraphBuilder& builder) const {
     const Vector<RHIGraphBuilder::FGPassDesc>& passes{ builder.GetPasses() };
     const u32 num_passes{ passes.Size() };
 
-    Vector<Vector<u32>> dependencies(num_passes);
+    DependencyList dependencies(num_passes);
 
-    std::unordered_map<FGResource, Vector<u32>> writers;
-    writers.reserve(num_passes * 2);
+    //Resources are indices into the builder, so writers can be a flat table
+    DependencyList writers(builder.GetResources().Size());
 
     for (u32 passIndex{ 0 }; passIndex < num_passes; ++passIndex) {
         for (const RHIGraphBuilder::FGResourceUsage& write : passes[passIndex].Writes) {
+            //CreateResource returns ~0 on failure
+            if (write.Resource >= writers.Size()) {
+                LOG_ERROR("Pass %s writes invalid resource %u!", passes[passIndex].Name, (u32)write.Resource);
+                continue;
+            }
+
             writers[write.Resource].PushBack(passIndex);
         }
     }
@@ -2729,11 +2696,10 @@ CRHIFrameGraph_DX12::GetDependencies(
         auto& deps = dependencies[passIndex];
 
         for (const RHIGraphBuilder::FGResourceUsage& read : passes[passIndex].Reads) {
-            auto it = writers.find(read.Resource);
-            if (it == writers.end())
+            if (read.Resource >= writers.Size())
                 continue;
 
-            for (u32 writerPass : it->second) {
+            for (u32 writerPass : writers[read.Resource]) {
                 if (writerPass != passIndex) {
                     deps.PushBack(writerPass);
                 }
@@ -2748,40 +2714,37 @@ CRHIFrameGraph_DX12::GetDependencies(
     return dependencies;
 }
 
-Vector<u32>
+ScratchVector<u32>
 CRHIFrameGraph_DX12::TopologicalSort(
-    const Vector<Vector<u32>>& dependencies) const {
+    const DependencyList& dependencies) const {
     const u32 numPasses = static_cast<u32>(dependencies.Size());
 
-    Vector<u32> inDegree(numPasses, 0);
-    Vector<std::vector<u32>> dependents(numPasses);
+    ScratchVector<u32> inDegree(numPasses, 0);
+    DependencyList dependents(numPasses);
 
     for (u32 pass = 0; pass < numPasses; ++pass) {
         for (u32 dep : dependencies[pass]) {
             ++inDegree[pass];
-            dependents[dep].push_back(pass);
+            dependents[dep].PushBack(pass);
         }
     }
 
-    std::queue<u32> ready;
+    //The sorted list doubles as the ready queue, passes before head are done
+    ScratchVector<u32> sorted;
+    sorted.Reserve(numPasses);
+
     for (u32 i = 0; i < numPasses; ++i) {
         if (inDegree[i] == 0) {
-            ready.push(i);
+            sorted.PushBack(i);
         }
     }
 
-    Vector<u32> sorted;
-    sorted.Reserve(numPasses);
-
-    while (!ready.empty()) {
-        u32 pass = ready.front();
-        ready.pop();
-
-        sorted.PushBack(pass);
+    for (u32 head = 0; head < sorted.Size(); ++head) {
+        const u32 pass = sorted[head];
 
         for (u32 dependent : dependents[pass]) {
             if (--inDegree[dependent] == 0) {
-                ready.push(dependent);
+                sorted.PushBack(dependent);
             }
         }
     }
@@ -2796,7 +2759,7 @@ CRHIFrameGraph_DX12::TopologicalSort(
 
 void
 CRHIFrameGraph_DX12::PrintDependencies(
-    const Vector<Vector<u32>>& dependencies) const {
+    const DependencyList& dependencies) const {
     LOG_DEBUG("Task Graph Dependencies:");
 
     for (u32 pass = 0; pass < dependencies.Size(); ++pass) {
@@ -1,3 +1,4 @@
+#include <Iron.Core/Concurrent.h>
 #include <Iron.RHI/RHI.h>
 #include <Iron.RHI/Src/DXGIShared/Shared.h>
 
@@ -5,8 +6,6 @@
 #include <dxgi1_6.h>
 
 #include <vector>
-#include <unordered_map>
-#include <deque>
 
 namespace Iron::RHI::D3D12 {
 class CRHISurface_DX12;
@@ -276,7 +275,8 @@ private:
         u32                 Index;
     };
 
-    std::deque<PendingFree>     m_PendingFrees;
+    //Frees may come from any thread, Collect() runs on the render thread
+    MpscQueue<PendingFree>      m_PendingFrees;
 };
 
 class DX12Barriers {
@@ -372,13 +372,7 @@ private:
 
 class CRHIDevice_DX12 : public IRHIDevice {
 public:
-    struct ResourceSlot {
-        u32         Generation : Id::GenerationBits{};
-        u32         DenseIndex : (32 - Id::GenerationBits) {};
-    };
-
     struct DenseResource {
-        u32                         SparseIndex{};
         ID3D12Resource*             Resource{};
         D3D12_GPU_VIRTUAL_ADDRESS   Address{};
         u32                         RowPitch{};//Buffer only
@@ -533,16 +527,14 @@ private:
     DX12CommandManager                              m_ComputeMgr{};
     DX12CommandManager                              m_CopyMgr{};
 
-    Vector<ResourceSlot>                            m_SparseResources;
-    Vector<DenseResource>                           m_DenseResources;
-    Vector<u32>                                     m_FreeSparseResources;
+    SlotMap<DenseResource, VirtualStorage>          m_Resources;
 
     Vector<PipelineLayout>                          m_PipelineLayouts;
     Vector<u32>                                     m_FreeLayouts;
 
     Vector<Pipeline>                                m_Pipelines;
     Vector<u32>                                     m_FreePsos;
-    std::unordered_map<u64, u32>                    m_PsoMap;
+    HashMap<u64, u32>                               m_PsoMap;
 };
 
 class CRHISurface_DX12 : public IRHISurface {
@@ -621,23 +613,23 @@ class CRHIFrameGraph_DX12 : public IRHIFrameGraph {
     };
 
     struct Pass {
-        u16                     NumRtvs : 3{};
-        u16                     HasDsv : 1{};
-        u16                     ClearedBinds : (RHI_MAX_TARGET_COUNT + 1) {};
+        u16                             NumRtvs : 3{};
+        u16                             HasDsv : 1{};
+        u16                             ClearedBinds : (RHI_MAX_TARGET_COUNT + 1) {};
 
-        BoundView               Rtvs[RHI_MAX_TARGET_COUNT]{};
-        BoundView               Dsv{};
-        Math::V4                RtvClearValues[RHI_MAX_TARGET_COUNT]{};
+        BoundView                       Rtvs[RHI_MAX_TARGET_COUNT]{};
+        BoundView                       Dsv{};
+        Math::V4                        RtvClearValues[RHI_MAX_TARGET_COUNT]{};
         struct {
-            f32                 Depth{};
-            u8                  Stencil{};
+            f32                         Depth{};
+            u8                          Stencil{};
         } DepthClearValue;
 
         //TODO: Replace with stream and offset
-        Vector<BoundView>       Srvs{};
-        Vector<BarrierDesc>     Barriers{};
+        InlineVector<BoundView, 8>      Srvs{};
+        InlineVector<BarrierDesc, 8>    Barriers{};
 
-        FGPassFunc              Func{};
+        FGPassFunc                      Func{};
 
         constexpr inline void EnableClearTarget(u16 slot) {
             ClearedBinds |= (1 << (slot + 1));
@@ -710,9 +702,12 @@ public:
         u64 frameNumber) override;
 
 private:
-    Vector<Vector<u32>> GetDependencies(const RHIGraphBuilder& builder) const;
-    Vector<u32> TopologicalSort(const Vector<Vector<u32>>& dependencies) const;
-    void PrintDependencies(const Vector<Vector<u32>>& dependencies) const;
+    //Compile time temporaries live in scratch memory, released when Initialize returns
+    using DependencyList = ScratchVector<InlineVector<u32, 8>>;
+
+    DependencyList GetDependencies(const RHIGraphBuilder& builder) const;
+    ScratchVector<u32> TopologicalSort(const DependencyList& dependencies) const;
+    void PrintDependencies(const DependencyList& dependencies) const;
 
     inline u32 CalculateTemporal(u64 frameNumber, u32 start, u32 count) {
         return start + (u32)(frameNumber % (u64)count);
@@ -3,6 +3,7 @@
 
 #include <dxgi1_6.h>
 #include <d3dcommon.h>
+#include <functional>
 
 #define LOG_HR(hr) LOG_ERROR(Iron::RHI::Shared::HrToString(hr));
 